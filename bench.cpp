@@ -0,0 +1,964 @@
+#include "bench.h"
+#include <charconv>   // For to_chars
+#include <algorithm>  // For sort
+#include <array>      // For array
+#include <atomic>     // For atomic
+#include <chrono>     // For steady_clock
+#include <cmath>      // For abs, sqrt
+#include <cstdio>     // For snprintf
+#include <cstring>    // For memcmp, memcpy
+#include <iomanip>    // For setw, fixed, setprecision
+#include <ctime>      // For localtime_r
+#include <iostream>   // For cout
+#include <random>     // For minstd_rand, mt19937_64, normal_distribution
+#include <sstream>    // For ostringstream
+#include <thread>     // For thread
+#include <variant>    // For variant, visit
+#include <vector>     // For vector
+#include "fastFormat.h" // For fastfmt
+#include "formatters.h" // For JsonFormatter, FastCsvFormatter
+#include "marketEvent.h" // For MarketEvent, visitEvent
+#include "marketData.h" // For MarketDataGenerator
+#include "philox.h"   // For Philox4x32
+#include "queueStress.h" // For runQueueStress
+#include "threadSafeQueue.h" // For ThreadSafeQueue
+#include "randomPrefill.h" // For PrefilledEngine
+#include "pipeline.h" // For defaultUniverse
+#include "netUtil.h"   // For connectTo, sendLine
+#include "tickBatch.h" // For TickBatch, summarize
+#include "tickValidator.h" // For TickValidator
+#include "webSocketServer.h" // For WebSocketSink
+
+#include <sys/epoll.h> // For epoll_create1, epoll_ctl, epoll_wait
+#include <sys/resource.h> // For getrlimit, setrlimit
+#include <sys/socket.h> // For recv
+#include <unistd.h>   // For close, getpid
+
+using namespace std;
+
+namespace {
+
+// Tick fields drawn from the real generator so the digit-length distribution matches production.
+struct TickFields {
+    vector<double> prices;
+    vector<long> volumes;
+    vector<chrono::system_clock::time_point> timestamps;
+};
+
+TickFields sampleTickFields(size_t count) {
+    TickFields fields;
+    vector<MarketDataGenerator> generators;
+    vector<SymbolSpec> universe = defaultUniverse();
+    for (size_t i = 0; i < universe.size(); ++i) {
+        generators.emplace_back(universe[i].symbol, universe[i].initialPrice, universe[i].initialVolume,
+                                mixSeed(42, i));
+    }
+    auto start = chrono::system_clock::now();
+    for (size_t i = 0; i < count; ++i) {
+        MarketDataTick tick = generators[i % generators.size()].generateTick();
+        fields.prices.push_back(tick.price);
+        fields.volumes.push_back(tick.volume);
+        fields.timestamps.push_back(start + chrono::microseconds(i * 37)); // ~27k ticks/s
+    }
+    return fields;
+}
+
+// Best-of-N nanoseconds per element for body(i) over count elements.
+template <typename Body>
+double timePerElement(size_t count, Body&& body) {
+    double best = 1e300;
+    for (int run = 0; run < 5; ++run) {
+        auto begin = chrono::steady_clock::now();
+        for (size_t i = 0; i < count; ++i) {
+            body(i);
+        }
+        double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - begin).count();
+        best = min(best, ns / static_cast<double>(count));
+    }
+    return best;
+}
+
+// The original getFormattedTimestamp: put_time through an ostringstream on every call.
+string putTimeTimestamp(chrono::system_clock::time_point timestamp) {
+    time_t tt = chrono::system_clock::to_time_t(timestamp);
+    tm tm = {};
+    localtime_r(&tt, &tm);
+    ostringstream oss;
+    oss << put_time(&tm, "%Y-%m-%d %H:%M:%S");
+    auto ms = chrono::duration_cast<chrono::milliseconds>(timestamp.time_since_epoch()) % 1000;
+    oss << "." << setfill('0') << setw(3) << ms.count();
+    return oss.str();
+}
+
+void printResult(const char* field, const char* method, double nsPerField) {
+    cout << "  " << left << setw(10) << field << setw(28) << method
+         << right << fixed << setprecision(2) << setw(8) << nsPerField << " ns/field" << endl;
+}
+
+int benchFormat() {
+    const size_t count = 1000000;
+    TickFields fields = sampleTickFields(count);
+    char buffer[128];
+    char reference[128];
+    uint64_t sink = 0; // Keeps the formatted bytes observable
+
+    cout << "Formatting " << count << " generated tick fields (best of 5):" << endl;
+
+    printResult("price", "snprintf(\"%.2f\")", timePerElement(count, [&](size_t i) {
+        sink += static_cast<uint64_t>(snprintf(buffer, sizeof(buffer), "%.2f", fields.prices[i])) + buffer[0];
+    }));
+    printResult("price", "to_chars(fixed, 2)", timePerElement(count, [&](size_t i) {
+        char* end = to_chars(buffer, buffer + sizeof(buffer), fields.prices[i], chars_format::fixed, 2).ptr;
+        sink += static_cast<uint64_t>(end - buffer) + buffer[0];
+    }));
+    printResult("price", "fastfmt::writeFixed(v, 2)", timePerElement(count, [&](size_t i) {
+        char* end = fastfmt::writeFixed(fields.prices[i], 2, buffer);
+        sink += static_cast<uint64_t>(end - buffer) + buffer[0];
+    }));
+    printResult("price", "fastfmt::writeFixed<2>", timePerElement(count, [&](size_t i) {
+        char* end = fastfmt::writeFixed<2>(fields.prices[i], buffer);
+        sink += static_cast<uint64_t>(end - buffer) + buffer[0];
+    }));
+
+    printResult("volume", "snprintf(\"%ld\")", timePerElement(count, [&](size_t i) {
+        sink += static_cast<uint64_t>(snprintf(buffer, sizeof(buffer), "%ld", fields.volumes[i])) + buffer[0];
+    }));
+    printResult("volume", "to_chars", timePerElement(count, [&](size_t i) {
+        char* end = to_chars(buffer, buffer + sizeof(buffer), fields.volumes[i]).ptr;
+        sink += static_cast<uint64_t>(end - buffer) + buffer[0];
+    }));
+    printResult("volume", "fastfmt::writeSigned", timePerElement(count, [&](size_t i) {
+        char* end = fastfmt::writeSigned(fields.volumes[i], buffer);
+        sink += static_cast<uint64_t>(end - buffer) + buffer[0];
+    }));
+
+    // Dense stream (~27k ticks per second) and the worst case of a new second on every tick
+    vector<chrono::system_clock::time_point> sparse;
+    for (size_t i = 0; i < count / 10; ++i) {
+        sparse.push_back(fields.timestamps[0] + chrono::milliseconds(i * 1001 + i % 1000));
+    }
+    MarketDataTick tick;
+    printResult("timestamp", "put_time + ostringstream", timePerElement(count / 10, [&](size_t i) {
+        sink += putTimeTimestamp(fields.timestamps[i]).size();
+    }));
+    printResult("timestamp", "getFormattedTimestamp", timePerElement(count / 10, [&](size_t i) {
+        tick.timestamp = fields.timestamps[i];
+        sink += tick.getFormattedTimestamp().size();
+    }));
+    printResult("timestamp", "fastfmt::writeTimestamp", timePerElement(count, [&](size_t i) {
+        char* end = fastfmt::writeTimestamp(fields.timestamps[i], buffer);
+        sink += static_cast<uint64_t>(end - buffer) + buffer[0];
+    }));
+    printResult("timestamp", "writeTimestamp, 1 tick/s", timePerElement(count / 10, [&](size_t i) {
+        char* end = fastfmt::writeTimestamp(sparse[i], buffer);
+        sink += static_cast<uint64_t>(end - buffer) + buffer[0];
+    }));
+
+    // Correctness: the fast paths must produce exactly the reference text.
+    size_t mismatches = 0;
+    for (size_t i = 0; i < count; ++i) {
+        char* refEnd = to_chars(reference, reference + sizeof(reference), fields.prices[i], chars_format::fixed, 2).ptr;
+        char* end = fastfmt::writeFixed<2>(fields.prices[i], buffer);
+        mismatches += (refEnd - reference != end - buffer || memcmp(reference, buffer, end - buffer) != 0);
+
+        refEnd = to_chars(reference, reference + sizeof(reference), fields.volumes[i]).ptr;
+        end = fastfmt::writeSigned(fields.volumes[i], buffer);
+        mismatches += (refEnd - reference != end - buffer || memcmp(reference, buffer, end - buffer) != 0);
+    }
+    // Prices on or next to a rounding tie, where a once-rounded scaled product can round the wrong
+    // way (1.115, 2.675), exact binary ties (x.125, x.375) and products beyond 2^52, against printf
+    vector<double> ties;
+    for (uint64_t k = 0; k < 200000; ++k) {
+        ties.push_back(static_cast<double>(k * 10 + 5) / 1000.0);
+        ties.push_back(static_cast<double>(k) + 0.125 * static_cast<double>(1 + 2 * (k % 4)));
+        ties.push_back(45035996273704.96 + static_cast<double>(k) * 0.0078125);
+    }
+    for (double price : ties) {
+        for (int decimals = 0; decimals <= (price < 1e9 ? 9 : 2); ++decimals) { // Within 2^63 / 10^decimals
+            int length = snprintf(reference, sizeof(reference), "%.*f", decimals, price);
+            char* end = fastfmt::writeFixed(price, decimals, buffer);
+            mismatches += (length != end - buffer || memcmp(reference, buffer, end - buffer) != 0);
+        }
+        int length = snprintf(reference, sizeof(reference), "%.2f", price);
+        char* end = fastfmt::writeFixed<2>(price, buffer);
+        mismatches += (length != end - buffer || memcmp(reference, buffer, end - buffer) != 0);
+    }
+    for (const vector<chrono::system_clock::time_point>* stamps : {&fields.timestamps, &sparse}) {
+        for (size_t i = 0; i < count / 10; ++i) {
+            string expected = putTimeTimestamp((*stamps)[i]);
+            char* end = fastfmt::writeTimestamp((*stamps)[i], buffer);
+            mismatches += (expected.size() != static_cast<size_t>(end - buffer) ||
+                           memcmp(expected.data(), buffer, expected.size()) != 0);
+        }
+    }
+    cout << "  mismatches vs reference: " << mismatches << " (checksum " << sink % 997 << ")" << endl;
+    return mismatches == 0 ? 0 : 1;
+}
+
+// Mixed trade/quote/book stream in random order, so the discriminator branch is unpredictable.
+vector<MarketEvent> sampleMarketEvents(size_t count) {
+    vector<MarketEvent> events;
+    events.reserve(count);
+    uint64_t state = 7;
+    for (size_t i = 0; i < count; ++i) {
+        uint64_t r = mixSeed(state, i);
+        int64_t timestampNs = static_cast<int64_t>(i) * 37000;
+        double price = 100.0 + static_cast<double>(r % 10000) / 100.0;
+        int64_t size = static_cast<int64_t>(r >> 48) + 1;
+        uint32_t sequence = static_cast<uint32_t>(i);
+        switch (r % 3) {
+        case 0:
+            events.push_back(mevent::makeTrade(timestampNs, "GOOG", sequence, price, size, Side::Sell));
+            break;
+        case 1:
+            events.push_back(mevent::makeQuote(timestampNs, "AAPL", sequence, price, size, price + 0.01, size + 1));
+            break;
+        default:
+            events.push_back(mevent::makeBookUpdate(timestampNs, "MSFT", sequence, Side::Buy,
+                                                    static_cast<uint16_t>(r % 10), BookAction::Update, price, size));
+            break;
+        }
+    }
+    return events;
+}
+
+// Notional of any event kind; the same work for every dispatch strategy.
+struct NotionalVisitor {
+    double operator()(const MarketEvent&, const TradePayload& t) const { return t.price * static_cast<double>(t.size); }
+    double operator()(const MarketEvent&, const QuotePayload& q) const {
+        return q.bidPrice * static_cast<double>(q.bidSize) + q.askPrice * static_cast<double>(q.askSize);
+    }
+    double operator()(const MarketEvent&, const BookUpdatePayload& b) const { return b.price * static_cast<double>(b.size); }
+};
+
+int benchEvents() {
+    const size_t count = 1000000;
+    const size_t workingSet = 8192; // 512 KB of events: measures dispatch, not memory bandwidth
+    vector<MarketEvent> events = sampleMarketEvents(workingSet);
+
+    // The same stream as heap-free std::variant values for comparison
+    using PayloadVariant = variant<TradePayload, QuotePayload, BookUpdatePayload>;
+    struct VariantEvent {
+        int64_t timestampNs;
+        char symbol[8];
+        PayloadVariant payload;
+    };
+    vector<VariantEvent> variants;
+    variants.reserve(workingSet);
+    for (const MarketEvent& event : events) {
+        VariantEvent v{event.timestampNs, {}, PayloadVariant{}};
+        memcpy(v.symbol, event.symbol, sizeof(v.symbol));
+        visitEvent([&](const MarketEvent&, const auto& payload) { v.payload = payload; }, event);
+        variants.push_back(v);
+    }
+
+    cout << "Dispatching " << count << " mixed events from a " << workingSet << "-event working set ("
+         << sizeof(MarketEvent) << "-byte MarketEvent vs "
+         << sizeof(VariantEvent) << "-byte std::variant record, best of 5):" << endl;
+
+    NotionalVisitor notional;
+    double tableSum = 0, variantSum = 0;
+    printResult("event", "visitEvent (MarketEvent)", timePerElement(count, [&](size_t i) {
+        tableSum += visitEvent(notional, events[i % workingSet]);
+    }));
+    printResult("event", "std::visit (std::variant)", timePerElement(count, [&](size_t i) {
+        variantSum += visit([&](const auto& payload) {
+            return notional(events[0], payload);
+        }, variants[i % workingSet].payload);
+    }));
+    bool agree = tableSum == variantSum;
+    cout << "  checksums " << (agree ? "agree" : "DIFFER") << " (" << fixed << setprecision(0) << tableSum << ")" << endl;
+    return agree ? 0 : 1;
+}
+
+// Per-batch price range, notional and volume: MarketDataTick rows vs TickBatch columns.
+int benchColumns() {
+    const size_t batches = 256; // 64k ticks: L2/L3-resident, so the layout is what is measured
+    const size_t count = batches * TickBatch::kCapacity;
+    TickFields fields = sampleTickFields(count);
+
+    SymbolTable table(vector<string>{"GOOG", "AAPL", "MSFT", "AMZN", "TSLA"});
+    vector<MarketDataTick> rows(count);
+    vector<TickBatch> columns(batches);
+    for (size_t i = 0; i < count; ++i) {
+        MarketDataTick& tick = rows[i];
+        tick.timestamp = fields.timestamps[i];
+        tick.symbol = table.name(static_cast<uint32_t>(i % table.size()));
+        tick.price = fields.prices[i];
+        tick.volume = fields.volumes[i];
+        TickBatch& batch = columns[i / TickBatch::kCapacity];
+        batch.symbols = &table;
+        batch.push(fields.timestamps[i].time_since_epoch().count(), static_cast<uint32_t>(i % table.size()),
+                   tick.price, tick.volume);
+    }
+
+    cout << "Summarizing " << batches << " batches of " << TickBatch::kCapacity << " ticks (best of 5):" << endl;
+
+    double rowsNotional = 0, columnsNotional = 0;
+    int64_t rowsVolume = 0, columnsVolume = 0;
+    printResult("tick", "MarketDataTick rows", timePerElement(batches, [&](size_t b) {
+        TickBatchSummary summary;
+        for (size_t i = b * TickBatch::kCapacity; i < (b + 1) * TickBatch::kCapacity; ++i) {
+            summary.minPrice = min(summary.minPrice, rows[i].price);
+            summary.maxPrice = max(summary.maxPrice, rows[i].price);
+            summary.notional += rows[i].price * static_cast<double>(rows[i].volume);
+            summary.volume += rows[i].volume;
+        }
+        rowsNotional += summary.notional + summary.maxPrice - summary.minPrice;
+        rowsVolume += summary.volume;
+    }) / TickBatch::kCapacity);
+    printResult("tick", "TickBatch columns", timePerElement(batches, [&](size_t b) {
+        TickBatchSummary summary = summarize(columns[b]);
+        columnsNotional += summary.notional + summary.maxPrice - summary.minPrice;
+        columnsVolume += summary.volume;
+    }) / TickBatch::kCapacity);
+
+    // Both layouts accumulate in the same order, so the results must match exactly.
+    bool agree = rowsNotional == columnsNotional && rowsVolume == columnsVolume;
+    cout << "  results " << (agree ? "agree" : "DIFFER") << endl;
+    return agree ? 0 : 1;
+}
+
+// Rows as csv-fast writes them: FastCsvFormatter over each tick of a batch.
+char* formatTickRows(const vector<MarketDataTick>& ticks, char* out) {
+    FastCsvFormatter formatter;
+    for (const MarketDataTick& tick : ticks) {
+        out = formatter.format(tick, out);
+    }
+    return out;
+}
+
+// Whole-batch CSV formatting: csv-fast over MarketDataTick rows vs csv-columnar over TickBatch columns.
+int benchBatchFormat() {
+    const size_t batches = 256;
+    const size_t count = batches * TickBatch::kCapacity;
+    TickFields fields = sampleTickFields(count);
+    SymbolTable table(vector<string>{"GOOG", "AAPL", "MSFT", "AMZN", "TSLA"});
+
+    // Generated ticks, then edge cases: zero, sub-cent, negative, 8/9/16/17-digit values
+    vector<TickBatch> columns(batches + 1);
+    vector<vector<MarketDataTick>> rows(batches + 1);
+    auto add = [&](size_t b, size_t i, uint32_t symbol, double price, int64_t volume) {
+        columns[b].symbols = &table;
+        columns[b].push(chrono::duration_cast<chrono::nanoseconds>(fields.timestamps[i].time_since_epoch()).count(),
+                        symbol, price, volume);
+        rows[b].push_back(MarketDataTick{columns[b].timestampAt(columns[b].size - 1), table.name(symbol), price,
+                                         static_cast<long>(volume)});
+    };
+    for (size_t i = 0; i < count; ++i) {
+        add(i / TickBatch::kCapacity, i, static_cast<uint32_t>(i % table.size()), fields.prices[i], fields.volumes[i]);
+    }
+    const double edgePrices[] = {0.0, 0.004, 0.005, 0.996, -0.001, -12.345, 99999.999, 999999.99,
+                                 1234567.891, 99999999999999.98, 1e15, -1e17, 123.455, 1e-300};
+    const int64_t edgeVolumes[] = {0, 1, -1, 9, 10, 99999999, 100000000, 9999999999999999,
+                                   10000000000000000, INT64_MAX, INT64_MIN, -100000000, 12345678, 42};
+    for (size_t i = 0; i < sizeof(edgePrices) / sizeof(edgePrices[0]); ++i) {
+        add(batches, i, 0, edgePrices[i], edgeVolumes[i]);
+    }
+
+    vector<char> reference(TickBatchCsvFormatter::maxRecordSize(columns[0]));
+    vector<char> buffer(reference.size());
+    TickBatchCsvFormatter formatter;
+    uint64_t sink = 0;
+
+    cout << "Formatting " << batches << " batches of " << TickBatch::kCapacity << " ticks to CSV (best of 5):" << endl;
+    printResult("row", "FastCsvFormatter, tick rows", timePerElement(batches, [&](size_t b) {
+        sink += static_cast<uint64_t>(formatTickRows(rows[b], reference.data()) - reference.data());
+    }) / TickBatch::kCapacity);
+    printResult("row", "TickBatchCsvFormatter", timePerElement(batches, [&](size_t b) {
+        sink += static_cast<uint64_t>(formatter.format(columns[b], buffer.data()) - buffer.data());
+    }) / TickBatch::kCapacity);
+
+    size_t mismatches = 0;
+    for (size_t b = 0; b < columns.size(); ++b) {
+        char* refEnd = formatTickRows(rows[b], reference.data());
+        char* end = formatter.format(columns[b], buffer.data());
+        mismatches += (refEnd - reference.data() != end - buffer.data() ||
+                       memcmp(reference.data(), buffer.data(), static_cast<size_t>(end - buffer.data())) != 0);
+    }
+    cout << "  mismatching batches vs csv-fast rows: " << mismatches << " (checksum " << sink % 997 << ")" << endl;
+    return mismatches == 0 ? 0 : 1;
+}
+
+// WebSocket fan-out to many loopback clients at a steady 32k ticks/s: a tenth never read, so they
+// end up conflated. Times the writer side (format + publish per step) and the final drain.
+int benchWebSocket() {
+    const size_t clients = 2000;
+    const size_t steps = 1000;
+    const chrono::microseconds stepInterval(2000);
+    vector<SymbolSpec> universe = makeUniverse(64);
+
+    rlimit limit = {};
+    getrlimit(RLIMIT_NOFILE, &limit);
+    if (limit.rlim_cur < clients * 2 + 64) {
+        limit.rlim_cur = min<rlim_t>(limit.rlim_max, clients * 2 + 64);
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+    if (limit.rlim_cur < clients * 2 + 64) {
+        cerr << "Error: --bench websocket needs " << clients * 2 + 64 << " file descriptors" << endl;
+        return 1;
+    }
+
+    string address = "/tmp/market_data_ws_bench." + to_string(getpid()) + ".sock";
+    JsonFormatter formatter;
+    WebSocketSink<JsonFormatter> sink(address, formatter);
+    if (!sink.isOpen()) {
+        return 1;
+    }
+
+    // One in ten subscribes to everything (half of those stall), the rest to two symbols each
+    vector<int> readers;
+    vector<int> stalled;
+    net::Endpoint endpoint = net::parseEndpoint(address);
+    for (size_t i = 0; i < clients; ++i) {
+        int fd = net::connectTo(endpoint);
+        string symbols = i % 20 == 0 || i % 20 == 9 ? "*"
+                                    : universe[i % universe.size()].symbol + "," +
+                                          universe[(i * 7) % universe.size()].symbol;
+        net::sendLine(fd, "GET /?symbols=" + symbols + " HTTP/1.1\r\nHost: bench\r\nUpgrade: websocket\r\n"
+                          "Connection: Upgrade\r\nSec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n"
+                          "Sec-WebSocket-Version: 13\r\n\r");
+        (i % 10 == 9 ? stalled : readers).push_back(fd);
+    }
+
+    atomic<size_t> upgraded{0};
+    atomic<uint64_t> received{0};
+    atomic<bool> done{false};
+    thread readerThread([&] {
+        int epollFd = epoll_create1(EPOLL_CLOEXEC);
+        for (size_t i = 0; i < readers.size(); ++i) {
+            net::setNonBlocking(readers[i]);
+            epoll_event event = {};
+            event.events = EPOLLIN;
+            event.data.u64 = i;
+            epoll_ctl(epollFd, EPOLL_CTL_ADD, readers[i], &event);
+        }
+        vector<bool> seen(readers.size(), false);
+        vector<char> buffer(64 * 1024);
+        epoll_event events[256];
+        while (!done.load()) {
+            int ready = epoll_wait(epollFd, events, 256, 10);
+            for (int e = 0; e < ready; ++e) {
+                size_t i = events[e].data.u64;
+                ssize_t n;
+                while ((n = recv(readers[i], buffer.data(), buffer.size(), 0)) > 0) {
+                    if (!seen[i]) {
+                        seen[i] = true;
+                        upgraded += memcmp(buffer.data(), "HTTP/1.1 101", 12) == 0;
+                    }
+                    received += static_cast<uint64_t>(n);
+                }
+                if (n == 0) {
+                    epoll_ctl(epollFd, EPOLL_CTL_DEL, readers[i], nullptr);
+                }
+            }
+        }
+        close(epollFd);
+    });
+    auto waitUntil = chrono::steady_clock::now() + chrono::seconds(10);
+    while (upgraded.load() < readers.size() && chrono::steady_clock::now() < waitUntil) {
+        this_thread::sleep_for(chrono::milliseconds(5));
+    }
+
+    vector<MarketDataGenerator> generators;
+    for (size_t i = 0; i < universe.size(); ++i) {
+        generators.emplace_back(universe[i].symbol, universe[i].initialPrice, universe[i].initialVolume,
+                                mixSeed(42, i));
+    }
+    vector<MarketDataTick> batch;
+    vector<double> publishMicros;
+    auto begin = chrono::steady_clock::now();
+    for (size_t step = 0; step < steps; ++step) {
+        this_thread::sleep_until(begin + step * stepInterval);
+        batch.clear();
+        for (MarketDataGenerator& generator : generators) {
+            batch.push_back(generator.generateTick());
+        }
+        auto publishBegin = chrono::steady_clock::now();
+        sink.writeBatch(batch, formatter);
+        sink.flush();
+        publishMicros.push_back(chrono::duration<double, micro>(chrono::steady_clock::now() - publishBegin).count());
+    }
+    auto closeBegin = chrono::steady_clock::now();
+    sink.close();
+    double drainMillis = chrono::duration<double, milli>(chrono::steady_clock::now() - closeBegin).count();
+    done = true;
+    readerThread.join();
+    for (int fd : readers) {
+        close(fd);
+    }
+    for (int fd : stalled) {
+        close(fd);
+    }
+
+    sort(publishMicros.begin(), publishMicros.end());
+    size_t ticks = steps * universe.size();
+    cout << "WebSocket fan-out: " << clients << " clients (" << stalled.size() << " never read), "
+         << universe.size() << " symbols, " << ticks << " ticks in steps of " << universe.size() << ":" << endl;
+    cout << fixed << setprecision(2)
+         << "  format + publish p50 " << setw(10) << publishMicros[publishMicros.size() / 2] << " us/step" << endl
+         << "  format + publish p99 " << setw(10) << publishMicros[publishMicros.size() * 99 / 100] << " us/step" << endl
+         << "  format + publish max " << setw(10) << publishMicros.back() << " us/step" << endl
+         << "  fan-out drain        " << setw(10) << drainMillis << " ms after the last publish" << endl
+         << "  upgraded readers     " << setw(10) << upgraded.load() << " of " << readers.size() << endl
+         << "  received by readers  " << setw(10) << received.load() / 1e6 << " MB" << endl;
+    return upgraded.load() == readers.size() ? 0 : 1;
+}
+
+// Catch-up time of one generator: advance(1) steps vs one advance(steps).
+template <typename Rng>
+void benchCatchUp(const char* engine) {
+    cout << "Catching up one " << engine << " generator (best of 5):" << endl;
+    for (uint64_t steps : {16ULL, 1000ULL, 1000000ULL}) {
+        BasicMarketDataGenerator<Rng> exact("GOOG", 150.0, 1000, 1), skipped("GOOG", 150.0, 1000, 1);
+        size_t calls = steps >= 1000000 ? 4 : 1000;
+        double exactNs = timePerElement(calls, [&](size_t) {
+            for (uint64_t i = 0; i < steps; ++i) {
+                exact.advance(1);
+            }
+        });
+        double skipNs = timePerElement(calls, [&](size_t) { skipped.advance(steps); });
+        cout << "  " << setw(8) << steps << " steps: " << fixed << setprecision(1) << setw(12) << exactNs
+             << " ns stepped, " << setw(10) << skipNs << " ns advance()" << endl;
+    }
+}
+
+// Generator catch-up: exact stepping vs one aggregated skip plus RNG jump-ahead. Checks that
+// the LCG jump matches discard() and that skipped price/volume moves have the exact moments.
+int benchSkip() {
+    using Generator = BasicMarketDataGenerator<minstd_rand>;
+    int failures = 0;
+
+    for (uint64_t n : {1ULL, 2ULL, 3ULL, 1000ULL, 123456789ULL}) {
+        minstd_rand stepped(12345), jumped(12345);
+        stepped.discard(n);
+        RngJump<minstd_rand>::jump(jumped, n);
+        failures += stepped() != jumped();
+    }
+    cout << "minstd_rand jump-ahead vs discard(): " << (failures == 0 ? "identical" : "MISMATCH") << endl;
+
+    // mt19937 (csv, feed, websocket) has no jump: its skips still discard() every skipped call
+    benchCatchUp<minstd_rand>("minstd_rand");
+    benchCatchUp<mt19937>("mt19937");
+
+    // Price and volume moves over 10000 skipped steps vs the exact sums' mean and variance
+    const size_t paths = 20000;
+    const uint64_t steps = 10000;
+    double priceSum = 0, priceSquares = 0, volumeSum = 0, volumeSquares = 0;
+    for (size_t i = 0; i < paths; ++i) {
+        Generator generator("S", 1000.0, 1000, mixSeed(7, i));
+        generator.advance(steps - 1);
+        MarketDataTick tick = generator.generateTick();
+        double price = tick.price - 1000.0;
+        double volume = static_cast<double>(tick.volume - 1000);
+        priceSum += price;
+        priceSquares += price * price;
+        volumeSum += volume;
+        volumeSquares += volume * volume;
+    }
+    double n = static_cast<double>(steps);
+    double priceVariance = priceSquares / paths - (priceSum / paths) * (priceSum / paths);
+    double volumeMean = volumeSum / paths;
+    double volumeVariance = volumeSquares / paths - volumeMean * volumeMean;
+    double expectedPriceVariance = 0.01 * n / 12.0;
+    double expectedVolumeVariance = n * (100.0 * 100.0 - 1.0) / 12.0;
+    cout << "Moments over " << steps << " steps, " << paths << " paths (expected):" << endl
+         << setprecision(4) << "  price mean " << priceSum / paths << " (0), variance " << priceVariance << " ("
+         << expectedPriceVariance << ")" << endl
+         << "  volume mean " << volumeMean << " (" << 50.5 * n << "), variance " << volumeVariance << " ("
+         << expectedVolumeVariance << ")" << endl;
+    // 5 standard errors on the means, 5% on the variances
+    bool momentsOk = abs(priceSum / paths) < 5 * sqrt(expectedPriceVariance / paths) &&
+                     abs(volumeMean - 50.5 * n) < 5 * sqrt(expectedVolumeVariance / paths) &&
+                     abs(priceVariance / expectedPriceVariance - 1) < 0.05 &&
+                     abs(volumeVariance / expectedVolumeVariance - 1) < 0.05;
+    cout << "  " << (momentsOk ? "within tolerance" : "OUT OF TOLERANCE") << endl;
+
+    // GBM: after a gap that jumps no normal refill, the next ticks take the same normals and
+    // volume increments as an exactly stepped generator, so their returns match.
+    using GbmGenerator = BasicMarketDataGenerator<mt19937_64, GbmModel>;
+    size_t gbmMismatches = 0;
+    for (uint64_t warmup : {0ULL, 50ULL, 255ULL}) { // Leaves 0, 206 and 1 normals buffered
+        for (uint64_t gap : {65ULL, 200ULL, 257ULL, 462ULL}) {
+            uint64_t buffered = warmup == 0 ? 0 : GbmModel::kNormalBuffer - warmup;
+            if (gap > buffered + GbmModel::kNormalBuffer) {
+                continue; // Would jump a refill
+            }
+            GbmGenerator stepped("S", 100.0, 1000, 11), skipped("S", 100.0, 1000, 11);
+            stepped.advance(warmup);
+            skipped.advance(warmup);
+            for (uint64_t i = 0; i < gap; ++i) {
+                stepped.generateTick();
+            }
+            skipped.advance(gap);
+            MarketDataTick steppedLast = stepped.generateTick(), skippedLast = skipped.generateTick();
+            for (int i = 0; i < 600; ++i) {
+                MarketDataTick a = stepped.generateTick(), b = skipped.generateTick();
+                gbmMismatches += abs(a.price / steppedLast.price - b.price / skippedLast.price) > 1e-12 ||
+                                 a.volume - steppedLast.volume != b.volume - skippedLast.volume;
+                steppedLast = a;
+                skippedLast = b;
+            }
+        }
+    }
+    // Log-price variance over a gap that also jumps refills: volatility^2 * steps
+    double logSquares = 0;
+    for (size_t i = 0; i < paths; ++i) {
+        GbmGenerator generator("S", 100.0, 1000, mixSeed(9, i));
+        generator.advance(steps - 1);
+        double logMove = log(generator.generateTick().price / 100.0);
+        logSquares += logMove * logMove;
+    }
+    double expectedLogVariance = 0.0002 * 0.0002 * n;
+    bool gbmOk = gbmMismatches == 0 && abs(logSquares / paths / expectedLogVariance - 1) < 0.05;
+    cout << "GBM catch-up: " << gbmMismatches << " returns differ from exact stepping after the gap; log-price variance "
+         << logSquares / paths << " (" << expectedLogVariance << ")" << endl
+         << "  " << (gbmOk ? "within tolerance" : "OUT OF TOLERANCE") << endl;
+    return failures == 0 && momentsOk && gbmOk ? 0 : 1;
+}
+
+// Engine throughput, Philox4x32-10 known-answer tests (Random123 kat_vectors), and the
+// counter-based property: a step's draws do not depend on what the engine did before.
+int benchRng() {
+    struct Kat {
+        Philox4x32::Block counter;
+        array<uint32_t, 2> key;
+        Philox4x32::Block expected;
+    };
+    const Kat kats[] = {
+        {{0, 0, 0, 0}, {0, 0}, {0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}},
+        {{0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff}, {0xffffffff, 0xffffffff},
+         {0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd}},
+        {{0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}, {0xa4093822, 0x299f31d0},
+         {0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}},
+    };
+    int failures = 0;
+    for (const Kat& kat : kats) {
+        failures += Philox4x32::block(kat.counter, kat.key) != kat.expected;
+    }
+    cout << "Philox4x32-10 known-answer tests: " << (failures == 0 ? "pass" : "FAIL") << endl;
+
+    Philox4x32 fresh(99), used(99);
+    fresh.setStep(5);
+    used.setStep(9);
+    used.discard(1001);
+    for (int i = 0; i < 3; ++i) {
+        used();
+    }
+    used.setStep(5);
+    bool pure = true;
+    for (int i = 0; i < 16; ++i) {
+        pure = pure && fresh() == used();
+    }
+    Philox4x32 stepped(7), skipped(7);
+    for (int i = 0; i < 1003; ++i) {
+        stepped();
+    }
+    skipped.discard(1003);
+    pure = pure && stepped() == skipped();
+    cout << "Step streams independent of history, O(1) discard: " << (pure ? "yes" : "NO") << endl;
+
+    const size_t count = 1 << 20;
+    uint64_t sink = 0;
+    cout << "Engine output (best of 5):" << endl;
+    auto engine = [&](const char* name, auto rng) {
+        printResult("uint32", name, timePerElement(count, [&](size_t) { sink += rng(); }));
+    };
+    engine("mt19937", mt19937(1));
+    engine("minstd_rand", minstd_rand(1));
+    engine("Philox4x32-10", Philox4x32(1));
+
+    cout << "Random walk step incl. tick (best of 5):" << endl;
+    auto walk = [&](const char* name, auto generator) {
+        printResult("tick", name, timePerElement(count / 16, [&](size_t) {
+            sink += static_cast<uint64_t>(generator.generateTick().volume);
+        }));
+    };
+    walk("mt19937", BasicMarketDataGenerator<mt19937>("GOOG", 150.0, 1000, 1));
+    walk("minstd_rand", BasicMarketDataGenerator<minstd_rand>("GOOG", 150.0, 1000, 1));
+    walk("Philox4x32-10", BasicMarketDataGenerator<Philox4x32>("GOOG", 150.0, 1000, 1));
+    cout << "  (checksum " << sink % 997 << ")" << endl;
+    return failures == 0 && pure ? 0 : 1;
+}
+
+// Normal draws: std::normal_distribution vs the ziggurat, one at a time and batched, plus the
+// batch's moments and tail mass against the standard normal.
+int benchNormal() {
+    const size_t count = 1 << 22;
+    vector<double> normals(count);
+    uint64_t checksum = 0;
+    double sink = 0;
+
+    cout << "Standard normal draws from mt19937_64 (best of 5):" << endl;
+    mt19937_64 rng(42);
+    normal_distribution<> distribution;
+    printResult("normal", "std::normal_distribution", timePerElement(count, [&](size_t) { sink += distribution(rng); }));
+    printResult("normal", "ZigguratNormal::draw", timePerElement(count, [&](size_t) { sink += ZigguratNormal::draw(rng); }));
+    printResult("normal", "ZigguratNormal::fill (256)", timePerElement(count / 256, [&](size_t b) {
+        ZigguratNormal::fill(rng, normals.data() + b * 256, 256);
+    }) / 256);
+
+    cout << "GBM vs random walk tick (best of 5):" << endl;
+    auto walk = [&](const char* name, auto generator) {
+        printResult("tick", name, timePerElement(count / 16, [&](size_t) { sink += generator.generateTick().price; }));
+    };
+    walk("random walk (mt19937)", BasicMarketDataGenerator<mt19937>("GOOG", 150.0, 1000, 1));
+    walk("GBM (mt19937_64)", BasicMarketDataGenerator<mt19937_64, GbmModel>("GOOG", 150.0, 1000, 1));
+
+    mt19937_64 fixed(7);
+    ZigguratNormal::fill(fixed, normals.data(), count);
+    double m1 = 0, m2 = 0, m3 = 0, m4 = 0;
+    size_t beyond3 = 0;
+    for (double z : normals) {
+        m1 += z;
+        m2 += z * z;
+        m3 += z * z * z;
+        m4 += z * z * z * z;
+        beyond3 += abs(z) > 3.0;
+        uint64_t word;
+        memcpy(&word, &z, sizeof(word));
+        checksum = checksum * 31 + word;
+    }
+    double n = static_cast<double>(count);
+    double tail = static_cast<double>(beyond3) / n;
+    cout << "Moments of " << count << " batched draws (expected):" << endl
+         << setprecision(5) << "  mean " << m1 / n << " (0), variance " << m2 / n << " (1), skewness " << m3 / n
+         << " (0), kurtosis " << m4 / n << " (3), P(|z| > 3) " << tail << " (0.0027)" << endl
+         << "  checksum " << hex << checksum << dec << " (identical with and without AVX2)" << endl;
+    bool ok = abs(m1 / n) < 0.003 && abs(m2 / n - 1) < 0.005 && abs(m3 / n) < 0.01 && abs(m4 / n - 3) < 0.03 &&
+              abs(tail - 0.0026998) < 0.0002;
+    cout << "  " << (ok ? "within tolerance" : "OUT OF TOLERANCE") << " (sink " << (sink != 0) << ")" << endl;
+    return ok ? 0 : 1;
+}
+
+template <typename T>
+struct TypeTag {
+    using type = T;
+};
+
+// Generation cost per step of 64 symbols, inline engines vs prefilled buffers, back to back and
+// paced. The prefilled producer does no engine work, but its refill thread needs CPU time of
+// its own: a spare core, or the idle time between paced steps.
+int benchPrefill() {
+    const size_t symbols = 64;
+    const size_t steps = 200000;
+    const size_t pacedSteps = 20000;
+    const chrono::microseconds pace(100);
+    uint64_t sink = 0;
+
+    auto run = [&](const char* name, auto tag, size_t count, chrono::microseconds idle) {
+        using Generator = typename decltype(tag)::type;
+        using Rng = typename Generator::RngType;
+        RngStream<Rng> stream(producerStreamSeed(42, 0));
+        vector<Generator> generators;
+        for (size_t i = 0; i < symbols; ++i) {
+            generators.emplace_back("S" + to_string(i), 100.0, 1000, mixSeed(42, i));
+        }
+        vector<double> stepNs;
+        stepNs.reserve(count);
+        for (size_t step = 0; step < count; ++step) {
+            auto begin = chrono::steady_clock::now();
+            for (Generator& generator : generators) {
+                sink += static_cast<uint64_t>(generator.generateTick().volume);
+            }
+            stepNs.push_back(chrono::duration<double, nano>(chrono::steady_clock::now() - begin).count());
+            if (idle.count() > 0) {
+                this_thread::sleep_for(idle);
+            }
+        }
+        sort(stepNs.begin(), stepNs.end());
+        cout << "  " << left << setw(30) << name << right << fixed << setprecision(0) << "p50 " << setw(7)
+             << stepNs[count / 2] << " ns  p99 " << setw(7) << stepNs[count * 99 / 100] << " ns  p99.9 " << setw(7)
+             << stepNs[count * 999 / 1000] << " ns";
+        if constexpr (is_same_v<Rng, PrefilledEngine<mt19937_64>>) {
+            cout << "  (" << stream.pool().stalls() << " refill stalls)";
+        }
+        cout << endl;
+    };
+    using Inline = TypeTag<BasicMarketDataGenerator<mt19937_64>>;
+    using Prefilled = TypeTag<BasicMarketDataGenerator<PrefilledEngine<mt19937_64>>>;
+
+    cout << "Generating " << steps << " steps of " << symbols << " ticks back to back, per-step cost:" << endl;
+    run("mt19937 inline", TypeTag<BasicMarketDataGenerator<mt19937>>(), steps, chrono::microseconds(0));
+    run("mt19937_64 inline", Inline(), steps, chrono::microseconds(0));
+    run("mt19937_64 prefilled", Prefilled(), steps, chrono::microseconds(0));
+    cout << "Generating " << pacedSteps << " steps of " << symbols << " ticks, " << pace.count()
+         << " us apart, per-step cost:" << endl;
+    run("mt19937_64 inline", Inline(), pacedSteps, pace);
+    run("mt19937_64 prefilled", Prefilled(), pacedSteps, pace);
+    cout << "  checksum " << sink % 997 << endl;
+    return 0;
+}
+
+// Validation cost per tick against formatting the same ticks, both over writer-sized batches of
+// a 1000-symbol universe, then one injected corruption of each kind to show every counter fires.
+int benchValidate() {
+    const size_t symbols = 1000;
+    const size_t steps = 500;
+    const size_t batchSize = 256;
+    vector<BasicMarketDataGenerator<mt19937>> generators;
+    for (size_t i = 0; i < symbols; ++i) {
+        generators.emplace_back("S" + to_string(i), 100.0, 1000, mixSeed(42, i));
+    }
+    vector<vector<MarketDataTick>> batches(1);
+    for (size_t step = 0; step < steps; ++step) {
+        for (auto& generator : generators) {
+            if (batches.back().size() == batchSize) {
+                batches.emplace_back();
+            }
+            batches.back().push_back(generator.generateTick());
+        }
+    }
+    vector<TickBatch> columns;
+    TickBatchPacker<TickBatch> packer([&] {
+        vector<string> names;
+        for (size_t i = 0; i < symbols; ++i) {
+            names.push_back("S" + to_string(i));
+        }
+        return names;
+    }());
+    struct Collect {
+        vector<TickBatch>& out;
+        void push(const TickBatch& batch) { out.push_back(batch); }
+    } collect{columns};
+    for (const auto& batch : batches) {
+        for (MarketDataTick tick : batch) {
+            packer.add(move(tick), collect);
+        }
+    }
+    packer.flush(collect);
+
+    const size_t ticks = symbols * steps;
+    uint64_t sink = 0;
+    char buffer[256];
+    cout << "Checking " << ticks << " ticks of " << symbols << " symbols in batches of " << batchSize
+         << " (best of 5):" << endl;
+    FastCsvFormatter formatter;
+    printResult("tick", "FastCsvFormatter::format", timePerElement(batches.size(), [&](size_t b) {
+        for (const MarketDataTick& tick : batches[b]) {
+            sink += static_cast<uint64_t>(formatter.format(tick, buffer) - buffer);
+        }
+    }) * static_cast<double>(batches.size()) / static_cast<double>(ticks));
+    // Each timing run replays the same ticks, so a fresh validator per run keeps the counts clean
+    auto validated = [&](auto& input, double tickSize) {
+        TickValidator validator(tickSize);
+        double ns = timePerElement(input.size(), [&](size_t b) {
+            if (b == 0) {
+                validator = TickValidator(tickSize);
+            }
+            validator.check(input[b]);
+        });
+        sink += validator.counts().ticks;
+        return make_pair(ns * static_cast<double>(input.size()) / static_cast<double>(ticks), validator.counts());
+    };
+    auto rows = validated(batches, 0.0);
+    printResult("tick", "validate MarketDataTick rows", rows.first);
+    auto rowsGrid = validated(batches, 0.01);
+    printResult("tick", "  + 0.01 tick grid", rowsGrid.first);
+    vector<vector<TickBatch>> columnBatches;
+    for (const TickBatch& batch : columns) {
+        columnBatches.push_back({batch});
+    }
+    auto cols = validated(columnBatches, 0.0);
+    printResult("tick", "validate TickBatch columns", cols.first);
+    bool clean = rows.second.violations() == 0 && cols.second.violations() == 0 && rows.second.ticks == ticks &&
+                 cols.second.ticks == ticks;
+    cout << "  clean stream: " << rows.second.violations() + cols.second.violations() << " violations, "
+         << rowsGrid.second.offGridPrices << " prices off a 0.01 grid (the walk is not quantized)" << endl;
+
+    // One corruption of each kind, in a copy of the stream
+    vector<vector<MarketDataTick>> corrupt = batches;
+    corrupt[3][10].price = -1.0;
+    corrupt[4][20].price = nan("");
+    corrupt[5][30].volume = 0;
+    corrupt[300][40].timestamp -= chrono::seconds(1);
+    corrupt[600][50] = corrupt[600][49];
+    TickValidator checker;
+    for (const auto& batch : corrupt) {
+        checker.check(batch);
+    }
+    const ValidationCounts& found = checker.counts();
+    cout << "Injected: 2 bad prices, 1 bad volume (also a sequence break), 1 timestamp regression, 1 duplicated tick"
+         << endl;
+    checker.print(cout, "corrupted stream");
+    bool fired = found.badPrices == 2 && found.badVolumes == 1 && found.timestampRegressions == 1 &&
+                 found.sequenceBreaks == 2;
+    cout << "  " << (clean && fired ? "all checks fire" : "UNEXPECTED COUNTS") << " (checksum " << sink % 997 << ")"
+         << endl;
+    return clean && fired ? 0 : 1;
+}
+
+// Randomized stress rounds over every pipeline queue: producer/consumer counts, item counts and
+// batch sizes vary per round, timing jitter per operation. Any lost, duplicated, reordered or
+// corrupted item fails the run; the round seed reproduces its configuration.
+int benchQueueStress() {
+    const int rounds = 12;
+    const uint64_t itemsPerRound = 100000;
+    int failures = 0;
+    auto stress = [&](const char* name, auto run) {
+        cout << name << ", " << rounds << " randomized rounds:" << endl;
+        for (int round = 0; round < rounds; ++round) {
+            mt19937_64 pick(static_cast<uint64_t>(round) + 1);
+            QueueStressConfig config;
+            config.seed = static_cast<uint64_t>(round) + 1;
+            config.producers = 1 + pick() % 8;
+            config.consumers = 1 + pick() % 4;
+            config.itemsPerProducer = static_cast<uint32_t>(itemsPerRound / config.producers);
+            config.maxBatch = 1 + pick() % 256;
+            auto begin = chrono::steady_clock::now();
+            QueueStressResult result = run(config);
+            double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - begin).count();
+            cout << "  seed " << setw(2) << config.seed << ": " << config.producers << "P/" << config.consumers
+                 << "C, batch <= " << setw(3) << config.maxBatch << ", " << result.popped << "/" << result.pushed
+                 << " popped, lost " << result.lost << ", duplicated " << result.duplicated << ", reordered "
+                 << result.reordered << ", corrupted " << result.corrupted << fixed << setprecision(1) << " ("
+                 << ms << " ms)" << (result.ok() ? "" : "  FAILED") << endl;
+            failures += !result.ok();
+        }
+    };
+    stress("ThreadSafeQueue", [](const QueueStressConfig& config) { return runQueueStress<ThreadSafeQueue>(config); });
+    cout << "  " << (failures == 0 ? "all properties hold" : "PROPERTY VIOLATIONS") << endl;
+    return failures == 0 ? 0 : 1;
+}
+
+struct BenchmarkEntry {
+    const char* name;
+    const char* description;
+    int (*run)();
+};
+
+const vector<BenchmarkEntry>& benchmarks() {
+    static const vector<BenchmarkEntry> entries = {
+        {"format", "price/volume/timestamp formatting: snprintf vs to_chars vs fastfmt", &benchFormat},
+        {"columns", "per-batch analytics over MarketDataTick rows vs TickBatch columns", &benchColumns},
+        {"batch-format", "CSV rows: FastCsvFormatter over ticks vs TickBatchCsvFormatter over batches", &benchBatchFormat},
+        {"events", "mixed event dispatch: 64-byte MarketEvent visitEvent vs std::variant", &benchEvents},
+        {"normal", "Gaussian draws: std::normal_distribution vs ziggurat (single, batched), moment checks", &benchNormal},
+        {"prefill", "paced per-step generation cost: inline engines vs background-prefilled buffers", &benchPrefill},
+        {"queue-stress", "randomized many-producer/consumer queue runs: no loss, duplication or reordering", &benchQueueStress},
+        {"rng", "engine throughput and Philox4x32-10 known answers / counter-based stream checks", &benchRng},
+        {"skip", "idle-symbol catch-up: exact steps vs aggregated skip + RNG jump-ahead", &benchSkip},
+        {"validate", "tick invariant checks per tick vs CSV formatting, plus injected-corruption detection", &benchValidate},
+        {"websocket", "JSON tick fan-out to 2000 loopback WebSocket clients, a tenth of them stalled", &benchWebSocket},
+    };
+    return entries;
+}
+
+} // namespace
+
+int runBenchmark(const string& name) {
+    for (const BenchmarkEntry& entry : benchmarks()) {
+        if (name == entry.name) {
+            return entry.run();
+        }
+    }
+    cerr << "Error: unknown benchmark '" << name << "'. Available benchmarks:\n";
+    listBenchmarks(cerr);
+    return 1;
+}
+
+void listBenchmarks(ostream& out) {
+    for (const BenchmarkEntry& entry : benchmarks()) {
+        out << "  " << left << setw(16) << entry.name << entry.description << "\n";
+    }
+}
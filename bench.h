@@ -0,0 +1,12 @@
+#ifndef MARKET_DATA_BENCH_H
+#define MARKET_DATA_BENCH_H
+
+#include <ostream>    // For std::ostream
+#include <string>     // For std::string
+
+// Built-in micro-benchmarks, selected with --bench NAME.
+// Returns a process exit status (non-zero if a benchmark's correctness check failed).
+int runBenchmark(const std::string& name);
+void listBenchmarks(std::ostream& out);
+
+#endif // MARKET_DATA_BENCH_H
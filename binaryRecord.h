@@ -0,0 +1,88 @@
+#ifndef MARKET_DATA_BINARY_RECORD_H
+#define MARKET_DATA_BINARY_RECORD_H
+
+#include <chrono>     // For std::chrono::system_clock
+#include <cstdint>    // For int64_t, uint64_t
+#include <cstring>    // For memcpy, memset, strnlen
+#include <string_view> // For std::string_view
+#include <type_traits> // For std::is_trivially_copyable
+#include "marketData.h" // For MarketDataTick
+
+// --- Fixed-Width Binary Tick Record ---
+// 32 bytes, all fields little-endian on disk:
+//   offset 0  int64   timestamp, nanoseconds since the Unix epoch
+//   offset 8  char[8] symbol, NUL-padded (longer symbols are truncated)
+//   offset 16 float64 price (IEEE-754)
+//   offset 24 int64   volume
+// The record is built once on the producer side so the writer can hand queue batches
+// straight to the kernel without touching individual ticks.
+struct TickRecord {
+    int64_t timestampNs;
+    char symbol[8];
+    double price;
+    int64_t volume;
+};
+static_assert(sizeof(TickRecord) == 32, "TickRecord must stay 32 bytes");
+static_assert(std::is_trivially_copyable<TickRecord>::value, "TickRecord is written as raw bytes");
+
+namespace binrec {
+
+constexpr bool kHostIsLittleEndian = __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__;
+
+inline uint64_t toLittleEndian(uint64_t value) {
+    return kHostIsLittleEndian ? value : __builtin_bswap64(value);
+}
+
+inline int64_t storeInt(int64_t value) {
+    return static_cast<int64_t>(toLittleEndian(static_cast<uint64_t>(value)));
+}
+
+inline double storeDouble(double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    bits = toLittleEndian(bits);
+    std::memcpy(&value, &bits, sizeof(bits));
+    return value;
+}
+
+inline TickRecord makeRecord(const MarketDataTick& tick) {
+    TickRecord record;
+    record.timestampNs = storeInt(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        tick.timestamp.time_since_epoch()).count());
+    std::memset(record.symbol, 0, sizeof(record.symbol));
+    std::memcpy(record.symbol, tick.symbol.data(),
+                tick.symbol.size() < sizeof(record.symbol) ? tick.symbol.size() : sizeof(record.symbol));
+    record.price = storeDouble(tick.price);
+    record.volume = storeInt(tick.volume);
+    return record;
+}
+
+inline std::chrono::system_clock::time_point timestampOf(const TickRecord& record) {
+    // Same byte swap in both directions
+    return std::chrono::system_clock::time_point(std::chrono::duration_cast<std::chrono::system_clock::duration>(
+        std::chrono::nanoseconds(storeInt(record.timestampNs))));
+}
+
+} // namespace binrec
+
+// --- Binary Record Formatter ---
+// Raw TickRecord bytes, no header. Sinks that can write Items directly (VectoredFileSink)
+// never call format(); byte-oriented sinks get a plain copy.
+struct BinaryRecordFormatter {
+    using Item = TickRecord;
+
+    static Item encode(MarketDataTick&& tick) { return binrec::makeRecord(tick); }
+    static std::chrono::system_clock::time_point timestampOf(const Item& record) { return binrec::timestampOf(record); }
+    static std::string_view symbolOf(const Item& record) {
+        return std::string_view(record.symbol, strnlen(record.symbol, sizeof(record.symbol)));
+    }
+    static const char* header() { return ""; }
+    static size_t maxRecordSize(const Item&) { return sizeof(Item); }
+
+    char* format(const Item& record, char* out) {
+        std::memcpy(out, &record, sizeof(record));
+        return out + sizeof(record);
+    }
+};
+
+#endif // MARKET_DATA_BINARY_RECORD_H
@@ -0,0 +1,340 @@
+#include "coordinator.h"
+#include <cerrno>     // For errno, EINTR
+#include <chrono>     // For steady_clock
+#include <cinttypes>  // For SCNu64
+#include <csignal>    // For sigaction, SIGINT
+#include <cstdio>     // For sscanf
+#include <cstring>    // For strerror
+#include <iomanip>    // For fixed, setprecision
+#include <iostream>
+#include <sstream>    // For ostringstream
+#include <stdexcept>  // For runtime_error
+#include "netUtil.h"  // For sockets and the line protocol
+
+#include <poll.h>     // For poll
+#include <spawn.h>    // For posix_spawn
+#include <sys/socket.h> // For accept4
+#include <sys/stat.h> // For stat
+#include <sys/wait.h> // For waitpid
+#include <unistd.h>   // For close, getpid, unlink
+
+extern char** environ;
+
+using namespace std;
+
+namespace {
+
+// --- Coordinator State ---
+struct WorkerStats {
+    int steps = 0;
+    uint64_t ticks = 0;
+    uint64_t elapsedUs = 0;
+    uint64_t bytes = 0;
+};
+
+struct WorkerConnection {
+    int fd;
+    net::LineReader reader;
+    long pid = 0;
+    size_t shard = 0;
+    bool greeted = false;   // HELLO received
+    bool finished = false;  // DONE received
+    bool closed = false;
+    int atStep = 0;         // Barrier this worker waits at (0 = running)
+    WorkerStats stats;
+
+    explicit WorkerConnection(int socketFd) : fd(socketFd), reader(socketFd) {}
+};
+
+volatile sig_atomic_t stopRequested = 0;
+
+void requestStop(int) { stopRequested = 1; }
+
+pid_t spawnWorker(const vector<string>& args) {
+    vector<char*> argv;
+    for (const string& arg : args) {
+        argv.push_back(const_cast<char*>(arg.c_str()));
+    }
+    argv.push_back(nullptr);
+
+    // Own process group: Ctrl+C reaches only the coordinator, which then stops the workers at a barrier
+    posix_spawnattr_t attributes;
+    posix_spawnattr_init(&attributes);
+    posix_spawnattr_setflags(&attributes, POSIX_SPAWN_SETPGROUP);
+    posix_spawnattr_setpgroup(&attributes, 0);
+    pid_t pid = -1;
+    int error = posix_spawn(&pid, "/proc/self/exe", nullptr, &attributes, argv.data(), environ);
+    posix_spawnattr_destroy(&attributes);
+    if (error != 0) {
+        throw runtime_error(string("cannot spawn worker: ") + strerror(error));
+    }
+    return pid;
+}
+
+double perSecond(uint64_t count, uint64_t elapsedUs) {
+    return elapsedUs > 0 ? static_cast<double>(count) * 1e6 / static_cast<double>(elapsedUs) : 0.0;
+}
+
+} // namespace
+
+// --- Coordinator ---
+int runCoordinator(const DistributedOptions& options) {
+    string endpointText = options.endpoint.empty()
+                              ? "unix:/tmp/market_data_coordinator." + to_string(getpid()) + ".sock"
+                              : options.endpoint;
+    net::Endpoint endpoint;
+    int listenFd = -1;
+    try {
+        endpoint = net::parseEndpoint(endpointText);
+        listenFd = net::listenOn(endpoint);
+    } catch (const exception& e) {
+        cerr << "[Coordinator] " << e.what() << endl;
+        return 1;
+    }
+
+    struct sigaction action = {};
+    action.sa_handler = requestStop;
+    sigaction(SIGINT, &action, nullptr);
+
+    vector<pid_t> children;
+    vector<string> args{"MarketDataSimulator"};
+    args.insert(args.end(), options.workerArgs.begin(), options.workerArgs.end());
+    args.push_back("--worker");
+    args.push_back(endpointText);
+    try {
+        for (size_t i = 0; i < options.workers; ++i) {
+            children.push_back(spawnWorker(args));
+        }
+    } catch (const exception& e) {
+        cerr << "[Coordinator] " << e.what() << endl;
+        stopRequested = 1; // Workers already started get STOP instead of START
+    }
+    cout << "[Coordinator] " << children.size() << " workers, " << options.barrierSteps
+         << "-step barriers, listening on " << endpointText << endl;
+
+    vector<unique_ptr<WorkerConnection>> workers;
+    size_t greeted = 0;
+    size_t running = children.size(); // Child processes not yet reaped
+    bool started = false;
+    bool failed = stopRequested != 0;
+    bool stopSent = false;
+    auto startTime = chrono::steady_clock::now();
+
+    auto broadcast = [&](const string& line) {
+        for (auto& worker : workers) {
+            if (!worker->closed && !worker->finished) {
+                net::sendLine(worker->fd, line);
+            }
+        }
+    };
+    auto stopAll = [&]() {
+        if (!stopSent) {
+            broadcast("STOP");
+            stopSent = true;
+        }
+    };
+    // Releases a barrier once every live worker waits at the same step.
+    auto checkBarrier = [&]() {
+        int step = 0;
+        for (auto& worker : workers) {
+            if (worker->closed || worker->finished) {
+                continue;
+            }
+            if (worker->atStep == 0 || (step != 0 && worker->atStep != step)) {
+                return;
+            }
+            step = worker->atStep;
+        }
+        if (step == 0 || stopSent) {
+            return;
+        }
+        if (stopRequested) {
+            cout << "[Coordinator] Stopping all workers at step " << step << endl;
+            stopAll();
+        } else {
+            broadcast("GO " + to_string(step));
+        }
+        for (auto& worker : workers) {
+            worker->atStep = 0;
+        }
+    };
+    auto handleLine = [&](WorkerConnection& worker, const string& line) {
+        int step = 0;
+        WorkerStats& stats = worker.stats;
+        if (line.compare(0, 6, "HELLO ") == 0 && !worker.greeted) {
+            worker.pid = strtol(line.c_str() + 6, nullptr, 10);
+            worker.greeted = true;
+            worker.shard = greeted++;
+            if (worker.shard >= options.workers) {
+                cerr << "[Coordinator] Unexpected extra worker (pid " << worker.pid << ")" << endl;
+                net::sendLine(worker.fd, "STOP");
+                worker.closed = true;
+                return;
+            }
+            net::sendLine(worker.fd, "ASSIGN " + to_string(worker.shard) + " " + to_string(options.workers) + " " +
+                                         to_string(options.barrierSteps));
+            if (greeted == options.workers && !stopSent) {
+                broadcast("START");
+                started = true;
+                startTime = chrono::steady_clock::now();
+            }
+        } else if (sscanf(line.c_str(), "AT %d", &step) == 1) {
+            worker.atStep = step;
+            checkBarrier();
+        } else if (sscanf(line.c_str(), "DONE %d %" SCNu64 " %" SCNu64 " %" SCNu64, &stats.steps, &stats.ticks,
+                          &stats.elapsedUs, &stats.bytes) == 4) {
+            worker.finished = true;
+            checkBarrier();
+        } else {
+            cerr << "[Coordinator] Unexpected message from worker " << worker.shard << ": " << line << endl;
+        }
+    };
+
+    // --- Event Loop ---
+    while (running > 0) {
+        vector<pollfd> fds{{listenFd, POLLIN, 0}};
+        for (auto& worker : workers) {
+            fds.push_back({worker->closed ? -1 : worker->fd, POLLIN, 0}); // Negative fds are ignored
+        }
+        int ready = poll(fds.data(), fds.size(), 200);
+        if (ready < 0 && errno != EINTR) {
+            cerr << "[Coordinator] poll: " << strerror(errno) << endl;
+            failed = true;
+            break;
+        }
+        if (stopRequested && !started) {
+            stopAll(); // Nothing to synchronize yet: stop whoever has connected
+        }
+
+        if (ready > 0 && (fds[0].revents & POLLIN)) {
+            int fd = accept4(listenFd, nullptr, nullptr, SOCK_CLOEXEC);
+            if (fd >= 0) {
+                workers.push_back(make_unique<WorkerConnection>(fd));
+                if (stopSent) {
+                    net::sendLine(fd, "STOP");
+                }
+            }
+        }
+        for (size_t i = 1; ready > 0 && i < fds.size(); ++i) {
+            WorkerConnection& worker = *workers[i - 1];
+            if (fds[i].revents == 0 || worker.closed) {
+                continue;
+            }
+            if (!worker.reader.fill()) {
+                worker.closed = true;
+                if (!worker.finished) {
+                    cerr << "[Coordinator] Worker " << worker.shard << " disconnected before finishing" << endl;
+                    failed = true;
+                    stopAll();
+                }
+                continue;
+            }
+            string line;
+            while (!worker.closed && worker.reader.nextLine(line)) {
+                handleLine(worker, line);
+            }
+        }
+
+        // Reap exited workers; one dying before it connects would otherwise stall START forever
+        int status = 0;
+        pid_t pid;
+        while (running > 0 && (pid = waitpid(-1, &status, WNOHANG)) > 0) {
+            --running;
+            if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+                cerr << "[Coordinator] Worker process " << pid << " failed" << endl;
+                failed = true;
+                stopAll();
+            }
+        }
+    }
+    auto wallUs = static_cast<uint64_t>(
+        chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - startTime).count());
+
+    for (auto& worker : workers) {
+        close(worker->fd);
+    }
+    close(listenFd);
+    if (!endpoint.tcp) {
+        unlink(endpoint.path.c_str());
+    }
+
+    // --- Aggregate Stats ---
+    WorkerStats total;
+    cout << fixed << setprecision(0);
+    for (auto& worker : workers) {
+        if (!worker->finished) {
+            continue;
+        }
+        const WorkerStats& stats = worker->stats;
+        cout << "[Coordinator] shard " << worker->shard << " (pid " << worker->pid << "): " << stats.steps
+             << " steps, " << stats.ticks << " ticks in " << stats.elapsedUs / 1000 << " ms ("
+             << perSecond(stats.ticks, stats.elapsedUs) << " ticks/s), " << stats.bytes << " bytes" << endl;
+        total.steps = max(total.steps, stats.steps);
+        total.ticks += stats.ticks;
+        total.bytes += stats.bytes;
+    }
+    cout << "[Coordinator] total: " << total.ticks << " ticks in " << wallUs / 1000 << " ms ("
+         << perSecond(total.ticks, wallUs) << " ticks/s aggregate), " << total.bytes << " bytes" << endl;
+    return failed ? 1 : 0;
+}
+
+// --- Worker ---
+int runWorker(const string& endpointText, const PipelineEntry& pipeline, PipelineOptions options) {
+    if (options.partitions > 1) {
+        cerr << "[Worker] --partitions is not supported together with --worker" << endl;
+        return 1;
+    }
+    int fd = -1;
+    try {
+        fd = net::connectTo(net::parseEndpoint(endpointText));
+    } catch (const exception& e) {
+        cerr << "[Worker] " << e.what() << endl;
+        return 1;
+    }
+    net::LineReader reader(fd);
+    string line;
+
+    unsigned long shard = 0;
+    unsigned long shards = 1;
+    int barrierSteps = 0;
+    if (!net::sendLine(fd, "HELLO " + to_string(getpid())) || !reader.readLine(line) ||
+        sscanf(line.c_str(), "ASSIGN %lu %lu %d", &shard, &shards, &barrierSteps) != 3 ||
+        !reader.readLine(line) || line != "START") {
+        // STOP before START: the coordinator gave up on the run
+        bool stopped = line == "STOP";
+        if (!stopped) {
+            cerr << "[Worker] Coordinator handshake failed" << endl;
+        }
+        net::sendLine(fd, "DONE 0 0 0 0");
+        close(fd);
+        return stopped ? 0 : 1;
+    }
+
+    options.shard = shard;
+    options.shards = shards;
+    options.output = partitionOutput(options.output, shard);
+    int completedSteps = 0;
+    options.onStep = [&](int step) {
+        completedSteps = step;
+        if (barrierSteps <= 0 || step % barrierSteps != 0 || step >= options.steps) {
+            return true;
+        }
+        // Simulated-time barrier: wait for every shard to reach this step
+        return net::sendLine(fd, "AT " + to_string(step)) && reader.readLine(line) && line.compare(0, 3, "GO ") == 0;
+    };
+
+    uint64_t ticksWritten = 0; // What was actually written: demand skipping and early stops included
+    options.ticksWritten = &ticksWritten;
+    auto start = chrono::steady_clock::now();
+    int status = pipeline.run(options);
+    auto elapsedUs = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count();
+
+    struct stat info = {};
+    uint64_t bytes = stat(options.output.c_str(), &info) == 0 ? static_cast<uint64_t>(info.st_size) : 0;
+
+    ostringstream done;
+    done << "DONE " << completedSteps << ' ' << ticksWritten << ' ' << elapsedUs << ' ' << bytes;
+    net::sendLine(fd, done.str());
+    close(fd);
+    return status;
+}
@@ -0,0 +1,39 @@
+#ifndef MARKET_DATA_COORDINATOR_H
+#define MARKET_DATA_COORDINATOR_H
+
+#include <cstddef>    // For size_t
+#include <string>     // For std::string
+#include <vector>     // For std::vector
+#include "pipeline.h" // For PipelineOptions, PipelineEntry
+
+// --- Multi-Process Simulation ---
+// A coordinator process spawns N worker processes of this executable. Each worker runs an
+// ordinary pipeline over one symbol-hash shard (PipelineOptions::shard/shards, the same hashing
+// as --partitions) and writes OUTPUT.pK.EXT. The coordinator talks to the workers over a Unix
+// or loopback TCP stream socket with newline-delimited text messages:
+//
+//   worker -> coordinator   HELLO <pid>
+//   coordinator -> worker   ASSIGN <shard> <shards> <barrierSteps>
+//   coordinator -> all      START                       once every worker has said HELLO
+//   worker -> coordinator   AT <step>                   every barrierSteps simulated steps
+//   coordinator -> all      GO <step> | STOP            once every running worker is AT step
+//   worker -> coordinator   DONE <steps> <ticks> <elapsedUs> <bytes>
+//
+// The step barriers keep the workers' simulated clocks within barrierSteps of each other, and
+// STOP (Ctrl+C on the coordinator, or a worker dying) ends every shard at the same step.
+
+struct DistributedOptions {
+    size_t workers = 0;          // --coordinator N: spawn and coordinate N worker processes
+    std::string endpoint;        // "unix:PATH", "PATH" or "HOST:PORT"; empty = a per-run Unix socket
+    int barrierSteps = 10;       // Simulated-time barrier interval, in steps
+    std::vector<std::string> workerArgs; // Pipeline options forwarded to every worker
+};
+
+// Listens on options.endpoint, spawns the workers, runs the barriers and prints aggregate stats.
+// Returns nonzero if a worker failed or disconnected early.
+int runCoordinator(const DistributedOptions& options);
+
+// Connects to a coordinator at endpoint and runs pipeline over the shard it assigns.
+int runWorker(const std::string& endpoint, const PipelineEntry& pipeline, PipelineOptions options);
+
+#endif // MARKET_DATA_COORDINATOR_H
@@ -0,0 +1,56 @@
+#include "fastFormat.h"
+#include <cstdint>    // For INT64_MIN
+#include <ctime>      // For localtime_r, time_t
+
+using namespace std;
+
+namespace fastfmt {
+
+namespace {
+
+// "YYYY-MM-DD HH:MM:SS." for one epoch second.
+struct SecondPrefix {
+    int64_t second = INT64_MIN;
+    char text[kTimestampPrefixLength];
+};
+
+void formatSecondPrefix(time_t tt, char* out) {
+    tm tm = {};
+#if defined(_MSC_VER)
+    localtime_s(&tm, &tt); // Use the safe version on MSVC
+#else
+    localtime_r(&tt, &tm); // Reentrant: the writer may format on several threads
+#endif
+
+    writeDigits(static_cast<uint64_t>(tm.tm_year + 1900), 4, out);
+    out[4] = '-';
+    memcpy(out + 5, &kDigits2[(tm.tm_mon + 1) * 2], 2);
+    out[7] = '-';
+    memcpy(out + 8, &kDigits2[tm.tm_mday * 2], 2);
+    out[10] = ' ';
+    memcpy(out + 11, &kDigits2[tm.tm_hour * 2], 2);
+    out[13] = ':';
+    memcpy(out + 14, &kDigits2[tm.tm_min * 2], 2);
+    out[16] = ':';
+    memcpy(out + 17, &kDigits2[tm.tm_sec * 2], 2);
+    out[19] = '.';
+}
+
+} // namespace
+
+char* writeTimestamp(chrono::system_clock::time_point timestamp, char* out) {
+    thread_local SecondPrefix cache;
+
+    auto sinceEpoch = timestamp.time_since_epoch();
+    auto second = chrono::floor<chrono::seconds>(sinceEpoch);
+    if (second.count() != cache.second) {
+        formatSecondPrefix(static_cast<time_t>(second.count()), cache.text);
+        cache.second = second.count();
+    }
+    memcpy(out, cache.text, kTimestampPrefixLength);
+    auto ms = chrono::duration_cast<chrono::milliseconds>(sinceEpoch - second);
+    writeDigits(static_cast<uint64_t>(ms.count()), 3, out + kTimestampPrefixLength);
+    return out + kTimestampLength;
+}
+
+} // namespace fastfmt
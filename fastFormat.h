@@ -0,0 +1,180 @@
+#ifndef MARKET_DATA_FAST_FORMAT_H
+#define MARKET_DATA_FAST_FORMAT_H
+
+#include <array>      // For std::array
+#include <chrono>     // For std::chrono::system_clock
+#include <cmath>      // For std::fabs, std::floor, std::fma
+#include <cstdint>    // For uint32_t, uint64_t
+#include <cstring>    // For memcpy
+
+// Locale-free number formatting for the writer hot path.
+// Integers are emitted right-to-left four (then two) digits at a time from lookup tables
+// built at compile time; digit counts come from a leading-zero count plus one comparison.
+namespace fastfmt {
+
+namespace detail {
+
+constexpr std::array<char, 200> makeDigits2() {
+    std::array<char, 200> table{};
+    for (int i = 0; i < 100; ++i) {
+        table[i * 2] = static_cast<char>('0' + i / 10);
+        table[i * 2 + 1] = static_cast<char>('0' + i % 10);
+    }
+    return table;
+}
+
+constexpr std::array<char, 40000> makeDigits4() {
+    std::array<char, 40000> table{};
+    for (int i = 0; i < 10000; ++i) {
+        table[i * 4] = static_cast<char>('0' + i / 1000);
+        table[i * 4 + 1] = static_cast<char>('0' + i / 100 % 10);
+        table[i * 4 + 2] = static_cast<char>('0' + i / 10 % 10);
+        table[i * 4 + 3] = static_cast<char>('0' + i % 10);
+    }
+    return table;
+}
+
+constexpr std::array<uint64_t, 20> makePow10() {
+    std::array<uint64_t, 20> table{};
+    uint64_t value = 1;
+    for (int i = 0; i < 20; ++i) {
+        table[i] = value;
+        value *= 10;
+    }
+    return table;
+}
+
+} // namespace detail
+
+// "00".."99" and "0000".."9999"
+inline constexpr std::array<char, 200> kDigits2 = detail::makeDigits2();
+inline constexpr std::array<char, 40000> kDigits4 = detail::makeDigits4();
+inline constexpr std::array<uint64_t, 20> kPow10 = detail::makePow10();
+
+// Number of decimal digits in value (1 for 0). No loop, one data-dependent compare.
+inline int countDigits(uint64_t value) {
+    // bits * log10(2) ~= bits * 1233 / 4096, which is either exact or one too small
+    uint64_t nonZero = value | 1; // 0 formats as "0"; cannot change the digit count of anything else
+    int bits = 64 - __builtin_clzll(nonZero);
+    int approx = (bits * 1233) >> 12;
+    return approx + (nonZero >= kPow10[approx] ? 1 : 0);
+}
+
+// Writes exactly `digits` digits of value (which must fit) ending at out + digits.
+inline void writeDigits(uint64_t value, int digits, char* out) {
+    char* p = out + digits;
+    while (digits >= 4) {
+        p -= 4;
+        std::memcpy(p, &kDigits4[(value % 10000) * 4], 4);
+        value /= 10000;
+        digits -= 4;
+    }
+    if (digits >= 2) {
+        p -= 2;
+        std::memcpy(p, &kDigits2[(value % 100) * 2], 2);
+        value /= 100;
+        digits -= 2;
+    }
+    if (digits == 1) {
+        *--p = static_cast<char>('0' + value);
+    }
+}
+
+// Decimal representation of value, returns the end pointer (no terminator).
+inline char* writeUnsigned(uint64_t value, char* out) {
+    int digits = countDigits(value);
+    writeDigits(value, digits, out);
+    return out + digits;
+}
+
+inline char* writeSigned(int64_t value, char* out) {
+    uint64_t magnitude = static_cast<uint64_t>(value);
+    if (value < 0) {
+        *out++ = '-';
+        magnitude = 0 - magnitude;
+    }
+    return writeUnsigned(magnitude, out);
+}
+
+namespace detail {
+
+// value * scale (value >= 0) rounded to the nearest integer as printf("%.*f") rounds: from the
+// exact binary value, ties to even. The product is rounded once in double, which can move it
+// across a .5 boundary (1.115 * 100 gives 111.5, but 1.115 is 1.11499999999999999112), so
+// products within an ulp of a tie are settled from the exact product, recovered with an fma.
+inline uint64_t roundScaled(double value, uint64_t scale) {
+    double product = value * static_cast<double>(scale);
+    uint64_t lower = static_cast<uint64_t>(static_cast<int64_t>(product)); // Truncates: floor for product >= 0
+    double fraction = product - static_cast<double>(lower); // Exact: both are within 1 of each other
+    double margin = product * 0x1p-52;                      // At least the rounding error of the product
+    if (std::fabs(fraction - 0.5) > margin) { // Branch-free rounding off the tie; rarely not taken
+        return lower + (fraction > 0.5 ? 1 : 0);
+    }
+    double error = std::fma(value, static_cast<double>(scale), -product); // Exact product - product
+    double aboveHalf; // Exact product - (lower + 0.5); only its sign and whether it is 0 matter
+    if (product < 0x1p52) {
+        // The error is under a quarter: the candidates are lower and lower + 1. The sum is
+        // rounded, but it is 0 only on an exact tie and otherwise keeps its sign.
+        aboveHalf = (fraction - 0.5) + error;
+    } else {
+        // product is an integer and the error can exceed 1. Both are multiples of value's ulp
+        // (at least 2^-30 here, as scale < 2^30), so these differences are exact.
+        double errorWhole = std::floor(error);
+        lower += static_cast<uint64_t>(static_cast<int64_t>(errorWhole));
+        aboveHalf = (error - errorWhole) - 0.5;
+    }
+    if (aboveHalf != 0.0) {
+        return lower + (aboveHalf > 0.0 ? 1 : 0);
+    }
+    return lower + (lower & 1); // Exact tie: to even
+}
+
+} // namespace detail
+
+// Fixed-point emission with a runtime number of decimals (0..9), e.g. per-symbol tick sizes.
+// Same digits as printf("%.*f"); prices beyond 2^63 / 10^decimals are out of range.
+inline char* writeFixed(double value, int decimals, char* out) {
+    if (value < 0) {
+        *out++ = '-';
+        value = -value;
+    }
+    uint64_t scale = kPow10[decimals];
+    uint64_t scaled = detail::roundScaled(value, scale);
+    out = writeUnsigned(scaled / scale, out);
+    if (decimals > 0) {
+        *out++ = '.';
+        writeDigits(scaled % scale, decimals, out);
+        out += decimals;
+    }
+    return out;
+}
+
+// Compile-time decimals: the divisions by the scale become multiplications.
+template <int Decimals>
+inline char* writeFixed(double value, char* out) {
+    static_assert(Decimals >= 0 && Decimals <= 9, "writeFixed supports 0..9 decimals");
+    constexpr uint64_t kScale = kPow10[Decimals];
+    if (value < 0) {
+        *out++ = '-';
+        value = -value;
+    }
+    uint64_t scaled = detail::roundScaled(value, kScale);
+    out = writeUnsigned(scaled / kScale, out);
+    if constexpr (Decimals > 0) {
+        *out++ = '.';
+        writeDigits(scaled % kScale, Decimals, out);
+        out += Decimals;
+    }
+    return out;
+}
+
+// "YYYY-MM-DD HH:MM:SS.mmm" in local time (same text as MarketDataTick::getFormattedTimestamp).
+// Each thread caches the formatted "YYYY-MM-DD HH:MM:SS." of the last epoch second it saw, so
+// ticks within one second cost a 20-byte copy plus three digits; localtime_r runs once per second.
+char* writeTimestamp(std::chrono::system_clock::time_point timestamp, char* out);
+constexpr size_t kTimestampLength = 23;
+constexpr size_t kTimestampPrefixLength = 20; // Up to and including the '.' before milliseconds
+
+} // namespace fastfmt
+
+#endif // MARKET_DATA_FAST_FORMAT_H
@@ -0,0 +1,433 @@
+#include "feedServer.h"
+#include <cerrno>     // For errno, EAGAIN, EINTR
+#include <chrono>     // For steady_clock
+#include <cstdio>     // For fwrite, fflush
+#include <cstring>    // For strerror
+#include <iostream>
+#include "perfCounters.h" // For per-stage hardware counters
+#include "trace.h"    // For MDS_TRACE_THREAD_NAME
+
+#include <netinet/in.h> // For IPPROTO_TCP
+#include <netinet/tcp.h> // For TCP_NODELAY
+#include <sys/epoll.h> // For epoll_create1, epoll_ctl, epoll_wait
+#include <sys/eventfd.h> // For eventfd
+#include <sys/socket.h> // For accept4, send, setsockopt
+#include <unistd.h>   // For read, write, close, unlink
+
+using namespace std;
+
+namespace {
+
+constexpr uint64_t kListenTag = ~0ULL;        // epoll_event.data of the listening socket
+constexpr uint64_t kWakeTag = ~0ULL - 1;      // ... of the eventfd; clients use their slot
+constexpr size_t kMaxCommandBytes = 64 * 1024; // Unterminated command input before disconnecting
+constexpr chrono::milliseconds kCloseGrace(1000);
+constexpr uint32_t kWildcard = ~0U;           // "*" in Client::symbols
+
+void watch(int epollFd, int op, int fd, uint32_t events, uint64_t tag) {
+    epoll_event event = {};
+    event.events = events;
+    event.data.u64 = tag;
+    epoll_ctl(epollFd, op, fd, &event);
+}
+
+// Calls visit(token) for each space- or comma-separated token of text from position start.
+template <typename Visit>
+void forEachToken(const string& text, size_t start, Visit visit) {
+    while (start < text.size()) {
+        size_t end = text.find_first_of(" ,", start);
+        if (end == string::npos) {
+            end = text.size();
+        }
+        if (end > start) {
+            visit(string_view(text).substr(start, end - start));
+        }
+        start = end + 1;
+    }
+}
+
+} // namespace
+
+// --- Setup and Shutdown ---
+FeedServer::FeedServer(const string& address, string greeting, size_t maxQueuedBytes)
+    : greeting_(move(greeting)), maxQueuedBytes_(maxQueuedBytes) {
+    try {
+        net::Endpoint endpoint = net::parseEndpoint(address);
+        listenFd_ = net::listenOn(endpoint);
+        unixPath_ = endpoint.tcp ? "" : endpoint.path;
+        net::setNonBlocking(listenFd_);
+    } catch (const exception& e) {
+        cerr << "[Feed] " << e.what() << endl;
+        if (listenFd_ >= 0) {
+            ::close(listenFd_);
+            listenFd_ = -1;
+        }
+        return;
+    }
+    epollFd_ = epoll_create1(EPOLL_CLOEXEC);
+    wakeFd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    watch(epollFd_, EPOLL_CTL_ADD, listenFd_, EPOLLIN, kListenTag);
+    watch(epollFd_, EPOLL_CTL_ADD, wakeFd_, EPOLLIN, kWakeTag);
+    cout << "[Feed] Serving subscribers on " << address << endl;
+    loopThread_ = thread(&FeedServer::eventLoop, this);
+}
+
+FeedServer::~FeedServer() {
+    close();
+}
+
+FeedChunk FeedServer::acquireChunk() {
+    lock_guard<mutex> lock(mutex_);
+    if (spare_.empty()) {
+        return FeedChunk();
+    }
+    FeedChunk chunk = move(spare_.back());
+    spare_.pop_back();
+    return chunk;
+}
+
+void FeedServer::publish(FeedChunk&& chunk) {
+    bool wake;
+    {
+        lock_guard<mutex> lock(mutex_);
+        wake = published_.empty(); // Otherwise a wakeup is already pending
+        published_.push_back(move(chunk));
+    }
+    if (wake) {
+        uint64_t one = 1;
+        ssize_t ignored = write(wakeFd_, &one, sizeof(one));
+        (void)ignored;
+    }
+}
+
+void FeedServer::trackDemand(SymbolDemand& demand) {
+    {
+        lock_guard<mutex> lock(mutex_);
+        pendingDemand_ = &demand;
+    }
+    uint64_t one = 1;
+    ssize_t ignored = write(wakeFd_, &one, sizeof(one));
+    (void)ignored;
+}
+
+void FeedServer::close() {
+    if (loopThread_.joinable()) {
+        {
+            lock_guard<mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        uint64_t one = 1;
+        ssize_t ignored = write(wakeFd_, &one, sizeof(one));
+        (void)ignored;
+        loopThread_.join();
+        cout << "[Feed] " << clientsAccepted_ << " clients served (" << slowDisconnects_
+             << " disconnected as too slow), " << recordsPublished_ << " records published, " << recordsDelivered_
+             << " deliveries, " << bytesSent_ << " bytes sent" << endl;
+    }
+    for (int* fd : {&listenFd_, &epollFd_, &wakeFd_}) {
+        if (*fd >= 0) {
+            ::close(*fd);
+            *fd = -1;
+        }
+    }
+    if (!unixPath_.empty()) {
+        unlink(unixPath_.c_str());
+        unixPath_.clear();
+    }
+}
+
+// --- Event Loop ---
+void FeedServer::eventLoop() {
+    MDS_TRACE_THREAD_NAME("feed");
+    perf::PerfCounterGroup publisherCounters;
+    publisherCounters.start();
+    epoll_event events[64];
+    bool draining = false;
+    auto deadline = chrono::steady_clock::now();
+
+    while (true) {
+        int ready = epoll_wait(epollFd_, events, 64, draining ? 20 : -1);
+        if (ready < 0 && errno != EINTR) {
+            cerr << "[Feed] epoll_wait: " << strerror(errno) << endl;
+            break;
+        }
+        for (int i = 0; i < ready; ++i) {
+            uint64_t tag = events[i].data.u64;
+            if (tag == kListenTag) {
+                acceptClients();
+            } else if (tag == kWakeTag) {
+                uint64_t count;
+                ssize_t ignored = read(wakeFd_, &count, sizeof(count));
+                (void)ignored;
+            } else if (clients_[tag]) {
+                Client& client = *clients_[tag];
+                if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+                    readCommands(client);
+                }
+                if (clients_[tag] && (events[i].events & EPOLLOUT)) {
+                    flushClient(client);
+                }
+            }
+        }
+
+        bool stopping = drainPublished();
+        for (uint32_t slot : dirty_) {
+            if (clients_[slot]) {
+                clients_[slot]->dirty = false;
+                flushClient(*clients_[slot]);
+            }
+        }
+        dirty_.clear();
+        for (uint32_t slot : slow_) {
+            if (clients_[slot]) {
+                cerr << "[Feed] Disconnecting slow client #" << slot << " (" << clients_[slot]->queued()
+                     << " bytes queued)" << endl;
+                ++slowDisconnects_;
+                disconnect(slot);
+            }
+        }
+        slow_.clear();
+        freeSlots_.insert(freeSlots_.end(), released_.begin(), released_.end());
+        released_.clear();
+
+        if (stopping && !draining) {
+            draining = true; // Everything is fanned out; give clients a moment to read it
+            deadline = chrono::steady_clock::now() + kCloseGrace;
+        }
+        if (draining) {
+            bool pending = false;
+            for (const auto& client : clients_) {
+                pending = pending || (client && client->queued() > 0);
+            }
+            if (!pending || chrono::steady_clock::now() >= deadline) {
+                break;
+            }
+        }
+    }
+    for (uint32_t slot = 0; slot < clients_.size(); ++slot) {
+        if (clients_[slot]) {
+            disconnect(slot);
+        }
+    }
+
+    publisherCounters.stop();
+    perf::recordStage("publisher", publisherCounters, recordsPublished_);
+}
+
+// Fans out every published chunk and recycles its buffers. Returns true once close() was called.
+bool FeedServer::drainPublished() {
+    vector<FeedChunk> chunks;
+    bool stopping;
+    SymbolDemand* demand;
+    {
+        lock_guard<mutex> lock(mutex_);
+        chunks.swap(published_);
+        stopping = stopping_;
+        demand = pendingDemand_;
+        pendingDemand_ = nullptr;
+    }
+    if (demand) {
+        subscribers_.attachDemand(*demand);
+    }
+    for (FeedChunk& chunk : chunks) {
+        fanOut(chunk);
+        chunk.clear();
+    }
+    if (!chunks.empty()) {
+        lock_guard<mutex> lock(mutex_);
+        for (FeedChunk& chunk : chunks) {
+            spare_.push_back(move(chunk));
+        }
+    }
+    return stopping;
+}
+
+void FeedServer::acceptClients() {
+    while (true) {
+        int fd = accept4(listenFd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                cerr << "[Feed] accept: " << strerror(errno) << endl;
+            }
+            if (errno != EINTR) {
+                return;
+            }
+            continue;
+        }
+        int noDelay = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay)); // Fails harmlessly on Unix sockets
+
+        uint32_t slot;
+        if (!freeSlots_.empty()) {
+            slot = freeSlots_.back();
+            freeSlots_.pop_back();
+        } else {
+            slot = static_cast<uint32_t>(clients_.size());
+            clients_.emplace_back();
+            subscribers_.reserveSlot(slot);
+        }
+        clients_[slot] = make_unique<Client>(fd, slot);
+        ++clientsAccepted_;
+        watch(epollFd_, EPOLL_CTL_ADD, fd, EPOLLIN, slot);
+        if (!greeting_.empty()) {
+            deliver(*clients_[slot], greeting_.data(), greeting_.size());
+        }
+    }
+}
+
+void FeedServer::disconnect(uint32_t slot) {
+    Client& client = *clients_[slot];
+    epoll_ctl(epollFd_, EPOLL_CTL_DEL, client.fd, nullptr);
+    ::close(client.fd);
+    while (!client.symbols.empty()) {
+        setSubscribed(client, client.symbols.back(), false);
+    }
+    clients_[slot].reset();
+    released_.push_back(slot);
+}
+
+// --- Subscriptions ---
+void FeedServer::readCommands(Client& client) {
+    if (!client.input.fill()) {
+        disconnect(client.slot);
+        return;
+    }
+    string line;
+    while (client.input.nextLine(line)) {
+        handleCommand(client, line);
+    }
+    if (client.input.buffered() > kMaxCommandBytes) {
+        cerr << "[Feed] Disconnecting client #" << client.slot << ": command line too long" << endl;
+        disconnect(client.slot);
+    }
+}
+
+void FeedServer::handleCommand(Client& client, const string& line) {
+    size_t space = line.find(' ');
+    string command = line.substr(0, space);
+    size_t arguments = space == string::npos ? line.size() : space + 1;
+    if (command == "SUB" || command == "UNSUB") {
+        bool subscribe = command == "SUB";
+        forEachToken(line, arguments, [&](string_view symbol) {
+            setSubscribed(client, symbol == "*" ? kWildcard : subscribers_.symbolId(symbol), subscribe);
+        });
+    } else if (!command.empty()) {
+        string error = "ERR unknown command " + command + "\n";
+        deliver(client, error.data(), error.size());
+    }
+}
+
+void FeedServer::setSubscribed(Client& client, uint32_t symbol, bool subscribed) {
+    bool changed = symbol == kWildcard ? subscribers_.subscribeAll(client.slot, subscribed)
+                                       : subscribers_.subscribe(client.slot, symbol, subscribed);
+    if (!changed) {
+        return;
+    }
+    if (subscribed) {
+        client.symbols.push_back(symbol);
+        return;
+    }
+    for (uint32_t& id : client.symbols) {
+        if (id == symbol) {
+            id = client.symbols.back();
+            client.symbols.pop_back();
+            break;
+        }
+    }
+}
+
+// --- Fan-Out ---
+void FeedServer::fanOut(const FeedChunk& chunk) {
+    for (const FeedChunk::Record& record : chunk.records) {
+        ++recordsPublished_;
+        uint32_t symbol = subscribers_.symbolId(string_view(chunk.symbols).substr(record.symbolOffset,
+                                                                                   record.symbolLength));
+        const char* data = chunk.data.data() + record.offset;
+        subscribers_.forEachSubscriber(symbol, [&](uint32_t slot) { deliver(*clients_[slot], data, record.length); });
+    }
+}
+
+void FeedServer::deliver(Client& client, const char* data, size_t length) {
+    if (client.slow) {
+        return;
+    }
+    if (client.queued() + length > maxQueuedBytes_) {
+        uint32_t slot = client.slot;
+        flushClient(client); // A burst may fit once the socket has taken what it can
+        if (!clients_[slot]) {
+            return; // The peer went away
+        }
+        if (client.queued() + length > maxQueuedBytes_) {
+            client.slow = true;
+            slow_.push_back(slot);
+            return;
+        }
+    }
+    client.output.append(data, length);
+    ++recordsDelivered_;
+    if (!client.dirty) {
+        client.dirty = true;
+        dirty_.push_back(client.slot);
+    }
+}
+
+void FeedServer::flushClient(Client& client) {
+    while (client.queued() > 0) {
+        ssize_t n = send(client.fd, client.output.data() + client.sent, client.queued(), MSG_NOSIGNAL);
+        if (n > 0) {
+            client.sent += static_cast<size_t>(n);
+            bytesSent_ += static_cast<uint64_t>(n);
+        } else if (n < 0 && errno == EINTR) {
+            continue;
+        } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            if (!client.waitingWritable) {
+                client.waitingWritable = true;
+                watch(epollFd_, EPOLL_CTL_MOD, client.fd, EPOLLIN | EPOLLOUT, client.slot);
+            }
+            if (client.sent > client.output.size() / 2) {
+                client.output.erase(0, client.sent); // Keep the unsent tail at the front
+                client.sent = 0;
+            }
+            return;
+        } else {
+            disconnect(client.slot); // Peer reset or closed
+            return;
+        }
+    }
+    client.output.clear();
+    client.sent = 0;
+    if (client.waitingWritable) {
+        client.waitingWritable = false;
+        watch(epollFd_, EPOLL_CTL_MOD, client.fd, EPOLLIN, client.slot);
+    }
+}
+
+// --- Subscriber Client ---
+int runSubscriber(const string& address, const string& symbols) {
+    int fd = -1;
+    try {
+        fd = net::connectTo(net::parseEndpoint(address));
+    } catch (const exception& e) {
+        cerr << "[Subscriber] " << e.what() << endl;
+        return 1;
+    }
+    if (!net::sendLine(fd, "SUB " + symbols)) {
+        cerr << "[Subscriber] Connection closed before subscribing" << endl;
+        ::close(fd);
+        return 1;
+    }
+    char buffer[1 << 16];
+    ssize_t n;
+    while ((n = read(fd, buffer, sizeof(buffer))) != 0) {
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        fwrite(buffer, 1, static_cast<size_t>(n), stdout);
+    }
+    fflush(stdout);
+    ::close(fd);
+    return 0;
+}
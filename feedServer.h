@@ -0,0 +1,194 @@
+#ifndef MARKET_DATA_FEED_SERVER_H
+#define MARKET_DATA_FEED_SERVER_H
+
+#include <cstddef>    // For size_t
+#include <cstdint>    // For uint32_t, uint64_t
+#include <memory>     // For std::unique_ptr
+#include <mutex>      // For std::mutex
+#include <string>     // For std::string
+#include <string_view> // For std::string_view
+#include <thread>     // For std::thread
+#include <vector>     // For std::vector
+#include "netUtil.h"  // For net::LineReader
+#include "subscriberIndex.h" // For SubscriberIndex
+#include "symbolDemand.h" // For SymbolDemand
+
+// --- Published Records ---
+// Formatted records plus the symbol of each one, handed from the writer thread to the
+// server's event loop in one piece.
+struct FeedChunk {
+    struct Record {
+        uint32_t offset;       // Into data
+        uint32_t length;
+        uint32_t symbolOffset; // Into symbols
+        uint32_t symbolLength;
+    };
+
+    std::vector<char> data;
+    std::string symbols;
+    std::vector<Record> records;
+
+    void clear() {
+        data.clear();
+        symbols.clear();
+        records.clear();
+    }
+};
+
+// --- Subscriber Feed Server ---
+// Streams published records to TCP (or Unix socket) subscribers from one epoll event loop
+// thread. Clients send text commands, one per line:
+//   SUB GOOG AAPL ...   add symbols (space or comma separated); "SUB *" subscribes to everything
+//   UNSUB GOOG ...      remove symbols; "UNSUB *" drops the wildcard subscription
+// and receive the formatter header followed by every matching record, unframed.
+//
+// Subscriptions live in a SubscriberIndex, so fan-out cost follows the matches, not
+// clients x records. A client whose unsent output exceeds maxQueuedBytes is too slow to keep
+// up, and it is disconnected rather than allowed to grow without bound.
+class FeedServer {
+public:
+    static constexpr size_t kDefaultMaxQueuedBytes = 4 << 20;
+
+    // Listens on address (see net::parseEndpoint); greeting is sent to every new client.
+    FeedServer(const std::string& address, std::string greeting, size_t maxQueuedBytes = kDefaultMaxQueuedBytes);
+    ~FeedServer();
+
+    FeedServer(const FeedServer&) = delete;
+    FeedServer& operator=(const FeedServer&) = delete;
+
+    bool isListening() const { return listenFd_ >= 0; }
+
+    // An empty chunk, reusing the buffers of one already fanned out when possible.
+    FeedChunk acquireChunk();
+
+    // Queues chunk for the event loop. Called from the pipeline's writer thread.
+    void publish(FeedChunk&& chunk);
+
+    // Mirrors this server's subscriptions into demand (from the event loop, shortly after).
+    void trackDemand(SymbolDemand& demand);
+
+    // Fans out everything published, gives clients a short grace period to drain, then
+    // disconnects them and stops the event loop.
+    void close();
+
+private:
+    struct Client {
+        int fd;
+        uint32_t slot;
+        net::LineReader input;
+        std::string output;    // output[sent..] is still to be sent
+        size_t sent = 0;
+        bool waitingWritable = false; // EPOLLOUT armed after a short write
+        bool dirty = false;           // Listed in dirty_
+        bool slow = false;            // Over maxQueuedBytes_: disconnected after the current chunk
+        std::vector<uint32_t> symbols; // Subscribed symbol ids (and the wildcard), released on disconnect
+
+        Client(int socketFd, uint32_t clientSlot) : fd(socketFd), slot(clientSlot), input(socketFd) {}
+        size_t queued() const { return output.size() - sent; }
+    };
+
+    // --- Event Loop (all below runs on loopThread_ only) ---
+    void eventLoop();
+    void acceptClients();
+    void readCommands(Client& client);
+    void handleCommand(Client& client, const std::string& line);
+    void fanOut(const FeedChunk& chunk);
+    void deliver(Client& client, const char* data, size_t length);
+    void flushClient(Client& client);
+    void disconnect(uint32_t slot);
+    bool drainPublished();
+    void setSubscribed(Client& client, uint32_t symbol, bool subscribed);
+
+    std::string greeting_;
+    size_t maxQueuedBytes_;
+    std::string unixPath_;     // Removed again by close()
+    int listenFd_ = -1;
+    int epollFd_ = -1;
+    int wakeFd_ = -1;          // eventfd: publish() and close() wake the loop
+
+    std::vector<std::unique_ptr<Client>> clients_; // By slot; null = free
+    std::vector<uint32_t> freeSlots_;
+    std::vector<uint32_t> dirty_;                  // Slots with output appended since the last flush pass
+    std::vector<uint32_t> slow_;                   // Slots to disconnect after the current chunk
+    std::vector<uint32_t> released_;               // Freed this round; reusable once its events are handled
+
+    SubscriberIndex subscribers_;
+
+    // Loop statistics, reported by close()
+    uint64_t clientsAccepted_ = 0;
+    uint64_t slowDisconnects_ = 0;
+    uint64_t recordsPublished_ = 0;
+    uint64_t recordsDelivered_ = 0;
+    uint64_t bytesSent_ = 0;
+
+    // --- Shared with the writer thread ---
+    std::mutex mutex_;
+    std::vector<FeedChunk> published_;
+    std::vector<FeedChunk> spare_;
+    SymbolDemand* pendingDemand_ = nullptr;
+    bool stopping_ = false;
+    std::thread loopThread_;
+};
+
+// --- Publishing Sink ---
+// Pipeline sink over a chunk-publishing server (FeedServer, WebSocketServer); the "path" is the
+// listen address. writeBatch formats into the current chunk and flush() publishes it, so the
+// writer's flush cadence sets the batching. The server fans out on its own thread.
+template <typename Server, typename Formatter>
+class PublishingSink {
+public:
+    using Item = typename Formatter::Item;
+
+    PublishingSink(const std::string& address, Formatter&) : server_(address, Formatter::header()) {}
+
+    bool isOpen() const { return server_.isListening(); }
+
+    void writeBatch(std::vector<Item>& batch, Formatter& formatter) {
+        size_t needed = 0;
+        for (const Item& item : batch) {
+            needed += Formatter::maxRecordSize(item);
+        }
+        size_t base = chunk_.data.size();
+        chunk_.data.resize(base + needed);
+        char* begin = chunk_.data.data();
+        char* out = begin + base;
+        for (const Item& item : batch) {
+            std::string_view symbol = Formatter::symbolOf(item);
+            char* end = formatter.format(item, out);
+            chunk_.records.push_back({static_cast<uint32_t>(out - begin), static_cast<uint32_t>(end - out),
+                                      static_cast<uint32_t>(chunk_.symbols.size()),
+                                      static_cast<uint32_t>(symbol.size())});
+            chunk_.symbols.append(symbol);
+            out = end;
+        }
+        chunk_.data.resize(static_cast<size_t>(out - begin));
+    }
+
+    // Lets the producers skip symbols no client subscribes to.
+    void trackDemand(SymbolDemand& demand) { server_.trackDemand(demand); }
+
+    void flush() {
+        if (!chunk_.records.empty()) {
+            server_.publish(std::move(chunk_));
+            chunk_ = server_.acquireChunk();
+        }
+    }
+
+    void close() {
+        flush();
+        server_.close();
+    }
+
+private:
+    Server server_;
+    FeedChunk chunk_;
+};
+
+template <typename Formatter>
+using FeedSink = PublishingSink<FeedServer, Formatter>;
+
+// Connects to a feed at address, subscribes to symbols ("GOOG,AAPL" or "*") and copies the
+// stream to stdout until the server closes it. Returns nonzero if the connection failed.
+int runSubscriber(const std::string& address, const std::string& symbols);
+
+#endif // MARKET_DATA_FEED_SERVER_H
@@ -0,0 +1,135 @@
+#ifndef MARKET_DATA_FORMATTERS_H
+#define MARKET_DATA_FORMATTERS_H
+
+#include <chrono>     // For std::chrono::system_clock
+#include <cstdio>     // For snprintf
+#include <cstring>    // For memcpy
+#include <string_view> // For std::string_view
+#include "fastFormat.h" // For fastfmt lookup-table number formatting
+#include "marketData.h" // For MarketDataTick
+
+// Formatters turn queue items into output bytes. Every formatter provides:
+//   using Item                         - the type carried by the pipeline queue
+//   static Item encode(MarketDataTick&&) - producer-side conversion from a generated tick
+//   static system_clock::time_point timestampOf(const Item&)
+//   static const char* header()         - written once at the start of the output
+//   static size_t maxRecordSize(const Item&) - upper bound of format() output
+//   char* format(const Item&, char* out) - writes one record, returns the end pointer
+//   static std::string_view symbolOf(const Item&) - routing key for per-symbol sinks
+// Formatters whose Item packs several ticks (e.g. TickBatchCsvFormatter in tickBatch.h) or needs
+// producer-side state (the MarketEvent formatters' per-symbol sequence numbers) provide
+// `using Packer` instead of encode(); see DirectPacker in pipeline.h for its interface.
+// They are template parameters of Pipeline and the sinks, so calls inline into the writer loop.
+
+// --- CSV Formatter ---
+// "Timestamp,Symbol,Price,Volume" rows, prices with two decimals.
+struct CsvFormatter {
+    using Item = MarketDataTick;
+
+    static Item encode(MarketDataTick&& tick) { return std::move(tick); }
+    static std::chrono::system_clock::time_point timestampOf(const Item& tick) { return tick.timestamp; }
+    static std::string_view symbolOf(const Item& tick) { return tick.symbol; }
+    static const char* header() { return "Timestamp,Symbol,Price,Volume\n"; }
+
+    // Timestamp (23) + price (up to 309 integer digits) + volume (20) + separators
+    static size_t maxRecordSize(const Item& tick) { return tick.symbol.size() + 384; }
+
+    char* format(const Item& tick, char* out) {
+        out = tick.formatTimestamp(out);
+        *out++ = ',';
+        std::memcpy(out, tick.symbol.data(), tick.symbol.size());
+        out += tick.symbol.size();
+        out += std::snprintf(out, 352, ",%.2f,%ld\n", tick.price, tick.volume);
+        return out;
+    }
+};
+
+// --- Fast CSV Formatter ---
+// Same rows as CsvFormatter, emitted with the fastfmt lookup tables instead of
+// snprintf/iostreams. PriceDecimals is fixed at compile time so the scaling folds away.
+template <int PriceDecimals>
+struct BasicFastCsvFormatter {
+    using Item = MarketDataTick;
+
+    static Item encode(MarketDataTick&& tick) { return std::move(tick); }
+    static std::chrono::system_clock::time_point timestampOf(const Item& tick) { return tick.timestamp; }
+    static std::string_view symbolOf(const Item& tick) { return tick.symbol; }
+    static const char* header() { return "Timestamp,Symbol,Price,Volume\n"; }
+
+    // Timestamp + price (20 integer digits, point, decimals) + volume (sign + 19) + separators
+    static size_t maxRecordSize(const Item& tick) { return tick.symbol.size() + 80; }
+
+    char* format(const Item& tick, char* out) {
+        out = fastfmt::writeTimestamp(tick.timestamp, out);
+        *out++ = ',';
+        std::memcpy(out, tick.symbol.data(), tick.symbol.size());
+        out += tick.symbol.size();
+        *out++ = ',';
+        out = fastfmt::writeFixed<PriceDecimals>(tick.price, out);
+        *out++ = ',';
+        out = fastfmt::writeSigned(tick.volume, out);
+        *out++ = '\n';
+        return out;
+    }
+};
+
+using FastCsvFormatter = BasicFastCsvFormatter<2>;
+
+// --- JSON Formatter ---
+// One object per tick, newline-terminated (NDJSON):
+//   {"ts":"2024-05-01 09:30:00.123","sym":"GOOG","px":150.25,"vol":1200}
+// Hand-written with the fastfmt routines straight into the sink's buffer; no DOM, no
+// allocation. The WebSocket server strips the newline and joins records into JSON arrays.
+struct JsonFormatter {
+    using Item = MarketDataTick;
+
+    static Item encode(MarketDataTick&& tick) { return std::move(tick); }
+    static std::chrono::system_clock::time_point timestampOf(const Item& tick) { return tick.timestamp; }
+    static std::string_view symbolOf(const Item& tick) { return tick.symbol; }
+    static const char* header() { return ""; }
+
+    // Keys and punctuation (34) + timestamp (23) + price (24) + volume (20); symbols escape to <= 6x
+    static size_t maxRecordSize(const Item& tick) { return tick.symbol.size() * 6 + 112; }
+
+    char* format(const Item& tick, char* out) {
+        out = writeLiteral(out, "{\"ts\":\"");
+        out = fastfmt::writeTimestamp(tick.timestamp, out);
+        out = writeLiteral(out, "\",\"sym\":\"");
+        out = writeEscaped(tick.symbol, out);
+        out = writeLiteral(out, "\",\"px\":");
+        out = fastfmt::writeFixed<2>(tick.price, out);
+        out = writeLiteral(out, ",\"vol\":");
+        out = fastfmt::writeSigned(tick.volume, out);
+        *out++ = '}';
+        *out++ = '\n';
+        return out;
+    }
+
+private:
+    template <size_t N>
+    static char* writeLiteral(char* out, const char (&text)[N]) {
+        std::memcpy(out, text, N - 1);
+        return out + N - 1;
+    }
+
+    // JSON string body: quotes, backslashes and control characters escaped.
+    static char* writeEscaped(std::string_view text, char* out) {
+        for (char c : text) {
+            unsigned char u = static_cast<unsigned char>(c);
+            if (c == '"' || c == '\\') {
+                *out++ = '\\';
+                *out++ = c;
+            } else if (u < 0x20) {
+                static const char kHex[] = "0123456789abcdef";
+                out = writeLiteral(out, "\\u00");
+                *out++ = kHex[u >> 4];
+                *out++ = kHex[u & 0xf];
+            } else {
+                *out++ = c;
+            }
+        }
+        return out;
+    }
+};
+
+#endif // MARKET_DATA_FORMATTERS_H
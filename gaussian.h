@@ -0,0 +1,182 @@
+#ifndef MARKET_DATA_GAUSSIAN_H
+#define MARKET_DATA_GAUSSIAN_H
+
+#include <cmath>      // For std::exp, std::log, std::sqrt, std::fabs
+#include <cstddef>    // For size_t
+#include <cstdint>    // For uint64_t, uint32_t
+#include <cstring>    // For std::memcpy
+
+#if defined(__AVX2__)
+#include <immintrin.h> // For AVX2 gathers
+#endif
+
+// 64 random bits from any engine: one call for 64-bit engines, two for 32-bit ones, and 16 bits
+// per call for narrower ranges such as minstd_rand's.
+template <typename Rng>
+inline uint64_t randomBits64(Rng& rng) {
+    constexpr uint64_t range = static_cast<uint64_t>(Rng::max() - Rng::min());
+    if constexpr (range == ~0ULL) {
+        return static_cast<uint64_t>(rng() - Rng::min());
+    } else if constexpr (range >= 0xFFFFFFFFULL) {
+        uint64_t high = static_cast<uint32_t>(rng() - Rng::min());
+        return (high << 32) | static_cast<uint32_t>(rng() - Rng::min());
+    } else {
+        uint64_t bits = 0;
+        for (int i = 0; i < 4; ++i) {
+            bits = (bits << 16) | ((rng() - Rng::min()) & 0xFFFF);
+        }
+        return bits;
+    }
+}
+
+// Engine calls behind one randomBits64().
+template <typename Rng>
+constexpr uint64_t randomBits64Calls() {
+    constexpr uint64_t range = static_cast<uint64_t>(Rng::max() - Rng::min());
+    return range == ~0ULL ? 1 : range >= 0xFFFFFFFFULL ? 2 : 4;
+}
+
+// --- Ziggurat Normal Sampler ---
+// Standard normal draws by the Marsaglia-Tsang ziggurat (256 layers, Doornik's formulation).
+// About 98.8% of draws cost one randomBits64, one table lookup, a compare and a multiply. The
+// rest go through the wedge or tail test. Stateless apart from the shared tables, unlike
+// std::normal_distribution, so one sampler serves every engine and thread.
+//
+// fill() produces a whole array. It converts all the bits first, then accepts four draws at
+// a time with AVX2 gathers when compiled for AVX2, with a scalar loop otherwise. Only
+// rejected lanes take the scalar wedge/tail path. Both paths consume the engine identically and
+// give bit-identical output.
+class ZigguratNormal {
+public:
+    template <typename Rng>
+    static double draw(Rng& rng) {
+        uint64_t bits = randomBits64(rng);
+        unsigned layer = static_cast<unsigned>(bits & 0xFF);
+        double u = signedUniform(bits);
+        const Tables& t = tables();
+        if (std::fabs(u) < t.ratio[layer]) {
+            return u * t.x[layer];
+        }
+        return finish(rng, u, layer);
+    }
+
+    template <typename Rng>
+    static void fill(Rng& rng, double* out, size_t count) {
+        constexpr size_t kChunk = 256;
+        uint64_t bits[kChunk];
+        const Tables& t = tables();
+        for (size_t base = 0; base < count; base += kChunk) {
+            size_t n = count - base < kChunk ? count - base : kChunk;
+            for (size_t k = 0; k < n; ++k) {
+                bits[k] = randomBits64(rng);
+            }
+            double* chunk = out + base;
+            size_t k = 0;
+#if defined(__AVX2__)
+            const __m256i mantissa = _mm256_set1_epi64x(0x3FF0000000000000LL);
+            const __m256i layerMask = _mm256_set1_epi64x(0xFF);
+            const __m256i lowWords = _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6);
+            for (; k + 4 <= n; k += 4) {
+                __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bits + k));
+                __m256d one = _mm256_castsi256_pd(_mm256_or_si256(_mm256_srli_epi64(b, 12), mantissa)); // [1, 2)
+                __m256d u = _mm256_sub_pd(_mm256_add_pd(one, one), _mm256_set1_pd(3.0));              // [-1, 1)
+                __m128i layers = _mm256_castsi256_si128(
+                    _mm256_permutevar8x32_epi32(_mm256_and_si256(b, layerMask), lowWords));
+                __m256d x = _mm256_i32gather_pd(t.x, layers, 8);
+                __m256d ratio = _mm256_i32gather_pd(t.ratio, layers, 8);
+                __m256d absU = _mm256_andnot_pd(_mm256_set1_pd(-0.0), u);
+                _mm256_storeu_pd(chunk + k, _mm256_mul_pd(u, x));
+                int accepted = _mm256_movemask_pd(_mm256_cmp_pd(absU, ratio, _CMP_LT_OQ));
+                if (accepted != 0xF) {
+                    for (int lane = 0; lane < 4; ++lane) {
+                        if (!(accepted & (1 << lane))) {
+                            chunk[k + lane] = finish(rng, signedUniform(bits[k + lane]),
+                                                     static_cast<unsigned>(bits[k + lane] & 0xFF));
+                        }
+                    }
+                }
+            }
+#endif
+            for (; k < n; ++k) {
+                unsigned layer = static_cast<unsigned>(bits[k] & 0xFF);
+                double u = signedUniform(bits[k]);
+                chunk[k] = std::fabs(u) < t.ratio[layer] ? u * t.x[layer] : finish(rng, u, layer);
+            }
+        }
+    }
+
+private:
+    static constexpr int kLayers = 256;
+    static constexpr double kR = 3.6541528853610088;    // Start of the tail
+    static constexpr double kArea = 0.00492867323399;   // Area of every layer
+
+    struct Tables {
+        double x[kLayers + 1];     // Layer edges; x[0] is the base layer's equivalent width
+        double ratio[kLayers];     // x[i + 1] / x[i]: |u| below this is inside the core rectangle
+        double f[kLayers + 1];     // exp(-x^2 / 2) at the edges
+
+        Tables() {
+            x[0] = kArea / density(kR);
+            x[1] = kR;
+            for (int i = 2; i < kLayers; ++i) {
+                x[i] = std::sqrt(-2.0 * std::log(kArea / x[i - 1] + density(x[i - 1])));
+            }
+            x[kLayers] = 0.0;
+            for (int i = 0; i < kLayers; ++i) {
+                ratio[i] = x[i + 1] / x[i];
+            }
+            for (int i = 0; i <= kLayers; ++i) {
+                f[i] = density(x[i]);
+            }
+        }
+    };
+
+    static const Tables& tables() {
+        static const Tables instance;
+        return instance;
+    }
+
+    static double density(double x) { return std::exp(-0.5 * x * x); }
+
+    // Uniform in [-1, 1) from the high 52 bits; the low 8 bits pick the layer.
+    static double signedUniform(uint64_t bits) {
+        uint64_t word = (bits >> 12) | 0x3FF0000000000000ULL;
+        double one;
+        std::memcpy(&one, &word, sizeof(one));
+        return 2.0 * one - 3.0;
+    }
+
+    // Uniform in (0, 1], safe for log().
+    template <typename Rng>
+    static double openUniform(Rng& rng) {
+        return static_cast<double>((randomBits64(rng) >> 11) + 1) * (1.0 / 9007199254740992.0);
+    }
+
+    // The slow path for a draw outside its layer's core rectangle.
+    template <typename Rng>
+    static double finish(Rng& rng, double u, unsigned layer) {
+        const Tables& t = tables();
+        while (true) {
+            if (layer == 0) {
+                double a, b;
+                do {
+                    a = -std::log(openUniform(rng)) / kR;
+                    b = -std::log(openUniform(rng));
+                } while (b + b < a * a);
+                return u < 0 ? -(kR + a) : kR + a;
+            }
+            double candidate = u * t.x[layer];
+            if (t.f[layer] + openUniform(rng) * (t.f[layer + 1] - t.f[layer]) < density(candidate)) {
+                return candidate;
+            }
+            uint64_t bits = randomBits64(rng);
+            layer = static_cast<unsigned>(bits & 0xFF);
+            u = signedUniform(bits);
+            if (std::fabs(u) < t.ratio[layer]) {
+                return u * t.x[layer];
+            }
+        }
+    }
+};
+
+#endif // MARKET_DATA_GAUSSIAN_H
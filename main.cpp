@@ -1,166 +1,202 @@
-#include <queue>      // For queue
-#include <mutex>      // For mutex
-#include <condition_variable> // For condition_variable
 #include <iostream>
 #include <string>
+#include <cstdlib>    // For strtol, strtod, strtoull
+#include <cstring>    // For strcmp
 #include <vector>
-#include <chrono>
-#include <thread>
-#include <random>
-#include <iomanip>      // For fixed and setprecision
-#include <sstream>      // For ostringstream
-#include <fstream>      // For ofstream (to write to file)
-#include "marketData.h" // Include the header file for declarations
+#include "bench.h"    // For --bench
+#include "coordinator.h" // For --coordinator / --worker
+#include "feedServer.h" // For --subscribe
+#include "pipeline.h" // For PipelineOptions and the registry of compiled pipelines
+#include "regression.h" // For --regress
 
 using namespace std;
 
-// --- Thread-Safe Queue for MarketDataTick ---
-// This queue will allow the main thread (producer) to push ticks
-// and the writer thread (consumer) to pop ticks safely.
-template <typename T>
-class ThreadSafeQueue {
-public:
-    void push(T value) {
-        lock_guard<mutex> lock(mtx_); // Acquire lock
-        queue_.push(move(value));         // Add item to queue
-        cv_.notify_one();                      // Notify one waiting thread
-    }
+// --- Command Line Options ---
+void printUsage(const char* program) {
+    cout << "Usage: " << program << " [--pipeline NAME] [--output FILE] [--steps N] [--delay-ms N] [--quiet]\n"
+         << "       [--seed N] [--symbols N] [--partitions N] [--merge] [--target-p99-us X]\n"
+         << "       [--validate [--tick-size X]] [--sim-clock]\n"
+         << "       [--coordinator N [--listen ADDRESS] [--barrier-steps N]] [--worker ADDRESS]\n"
+         << "       [--subscribe ADDRESS SYMBOLS] [--list-pipelines] [--bench NAME]\n"
+         << "       [--regress FILE | --regress-fast FILE | --regress-update FILE]\n"
+         << "  --pipeline NAME    compiled pipeline configuration to run, default csv\n"
+         << "  --output FILE      output file, default multi_symbol_threaded_market_data_output2.csv\n"
+         << "  --steps N          simulation steps (one tick per symbol per step), default 50\n"
+         << "  --delay-ms N       sleep between steps, default 100\n"
+         << "  --quiet            do not echo ticks to the console\n"
+         << "  --seed N           deterministic generator seeding (0 = std::random_device)\n"
+         << "  --symbols N        simulate N instruments (the five defaults plus synthetic ones), default 5\n"
+         << "  --partitions N     split symbols by hash into N independent generator/queue/writer lanes,\n"
+         << "                     each writing OUTPUT.pK.EXT, default 1\n"
+         << "  --merge            with --partitions, merge the lanes by timestamp into OUTPUT instead\n"
+         << "  --target-p99-us X  auto-tune batch size, flush interval and spinning for p99 latency <= X us\n"
+         << "                     (latency is measured from wall-clock tick timestamps: not with --sim-clock)\n"
+         << "  --validate         check every written tick (positive prices and volumes, per-symbol timestamp\n"
+         << "                     order and volume sequence); report violations and exit 1 on any\n"
+         << "  --tick-size X      with --validate, also check that prices lie on a grid of X\n"
+         << "  --sim-clock        timestamp ticks with simulated time (one step = --delay-ms, at least 1 ms)\n"
+         << "                     instead of the wall clock, so seeded runs are reproducible byte for byte\n"
+         << "  --coordinator N    run N worker processes, one symbol-hash shard each (OUTPUT.pK.EXT),\n"
+         << "                     synchronized at simulated-time barriers\n"
+         << "  --listen ADDRESS   coordinator socket: unix:PATH or HOST:PORT, default a Unix socket in /tmp\n"
+         << "  --barrier-steps N  steps between coordinator barriers, default 10\n"
+         << "  --worker ADDRESS   run as a worker of the coordinator at ADDRESS (started by --coordinator)\n"
+         << "  --subscribe ADDRESS SYMBOLS  print the rows of a --pipeline feed server for SYMBOLS\n"
+         << "                     (comma separated, * = all)\n"
+         << "  --list-pipelines   show the available pipeline configurations and benchmarks\n"
+         << "  --bench NAME       run a built-in micro-benchmark instead of the simulation\n"
+         << "  --regress FILE     run every file pipeline and tick stream on a fixed seeded configuration and\n"
+         << "                     compare their XXH64 checksums with the golden manifest FILE (e.g. golden.txt)\n"
+         << "  --regress-fast FILE  the same for the generator tick streams only\n"
+         << "  --regress-update FILE  rewrite FILE from the current outputs"
+         << endl;
+}
 
-    // Attempts to pop an item without blocking. Returns true if successful, false otherwise.
-    bool try_pop(T& value) {
-        lock_guard<mutex> lock(mtx_);
-        if (queue_.empty()) {
+// Options a coordinator passes on to its workers: everything that configures the pipeline itself.
+bool isPipelineOption(const char* arg) {
+    for (const char* local : {"--coordinator", "--listen", "--barrier-steps", "--worker", "--subscribe",
+                             "--list-pipelines", "--bench", "--regress", "--regress-fast", "--regress-update"}) {
+        if (strcmp(arg, local) == 0) {
             return false;
         }
-        value = move(queue_.front());
-        queue_.pop();
-        return true;
     }
+    return true;
+}
 
-    // Pops an item, blocking if the queue is empty until an item is available or stop is signaled.
-    void wait_and_pop(T& value) {
-        unique_lock<mutex> lock(mtx_);
-        // Wait until queue is not empty OR stop signal is received
-        cv_.wait(lock, [this] { return !queue_.empty() || stop_requested_; });
-
-        if (stop_requested_ && queue_.empty()) {
-            // If stop was requested and queue is empty, we are done
-            // Re-notify to ensure other waiting threads also wake up and exit if needed
-            cv_.notify_all();
-            throw runtime_error("ThreadSafeQueue stopped."); // Or handle more gracefully
+bool parseOptions(int argc, char* argv[], PipelineOptions& options, DistributedOptions& distributed,
+                  string& workerOf, vector<string>& subscription, bool& listOnly, string& benchmark,
+                  string& regression, RegressionMode& regressionMode) {
+    for (int i = 1; i < argc; ++i) {
+        auto value = [&]() -> const char* { return i + 1 < argc ? argv[++i] : nullptr; };
+        const char* arg = argv[i];
+        const char* v = nullptr;
+        int first = i;
+        if (strcmp(arg, "--coordinator") == 0 && (v = value())) {
+            distributed.workers = static_cast<size_t>(strtoull(v, nullptr, 10));
+        } else if (strcmp(arg, "--listen") == 0 && (v = value())) {
+            distributed.endpoint = v;
+        } else if (strcmp(arg, "--barrier-steps") == 0 && (v = value())) {
+            distributed.barrierSteps = static_cast<int>(strtol(v, nullptr, 10));
+        } else if (strcmp(arg, "--worker") == 0 && (v = value())) {
+            workerOf = v;
+        } else if (strcmp(arg, "--pipeline") == 0 && (v = value())) {
+            options.pipeline = v;
+        } else if (strcmp(arg, "--output") == 0 && (v = value())) {
+            options.output = v;
+        } else if (strcmp(arg, "--steps") == 0 && (v = value())) {
+            options.steps = static_cast<int>(strtol(v, nullptr, 10));
+        } else if (strcmp(arg, "--delay-ms") == 0 && (v = value())) {
+            options.delayMs = static_cast<int>(strtol(v, nullptr, 10));
+        } else if (strcmp(arg, "--quiet") == 0) {
+            options.echo = false;
+        } else if (strcmp(arg, "--seed") == 0 && (v = value())) {
+            options.seed = strtoull(v, nullptr, 10);
+        } else if (strcmp(arg, "--symbols") == 0 && (v = value())) {
+            options.symbols = static_cast<size_t>(strtoull(v, nullptr, 10));
+            if (options.symbols > kMaxUniverseSymbols) {
+                cerr << "Error: --symbols is limited to " << kMaxUniverseSymbols << endl;
+                return false;
+            }
+        } else if (strcmp(arg, "--partitions") == 0 && (v = value())) {
+            options.partitions = static_cast<size_t>(strtoull(v, nullptr, 10));
+        } else if (strcmp(arg, "--merge") == 0) {
+            options.merge = true;
+        } else if (strcmp(arg, "--target-p99-us") == 0 && (v = value())) {
+            options.targetP99Us = strtod(v, nullptr);
+        } else if (strcmp(arg, "--sim-clock") == 0) {
+            options.simulatedClock = true;
+        } else if (strcmp(arg, "--validate") == 0) {
+            options.validate = true;
+        } else if (strcmp(arg, "--tick-size") == 0 && (v = value())) {
+            options.tickSize = strtod(v, nullptr);
+        } else if (strcmp(arg, "--subscribe") == 0 && (v = value())) {
+            const char* symbols = value();
+            if (symbols == nullptr) {
+                return false;
+            }
+            subscription = {v, symbols};
+        } else if (strcmp(arg, "--list-pipelines") == 0) {
+            listOnly = true;
+        } else if (strcmp(arg, "--bench") == 0 && (v = value())) {
+            benchmark = v;
+        } else if (strcmp(arg, "--regress") == 0 && (v = value())) {
+            regression = v;
+            regressionMode = RegressionMode::Full;
+        } else if (strcmp(arg, "--regress-fast") == 0 && (v = value())) {
+            regression = v;
+            regressionMode = RegressionMode::Fast;
+        } else if (strcmp(arg, "--regress-update") == 0 && (v = value())) {
+            regression = v;
+            regressionMode = RegressionMode::Update;
+        } else {
+            return false;
         }
-
-        value = move(queue_.front());
-        queue_.pop();
-    }
-
-    // Signals the queue to stop, causing waiting consumers to wake up and exit.
-    void stop() {
-        lock_guard<mutex> lock(mtx_);
-        stop_requested_ = true;
-        cv_.notify_all(); // Notify all waiting threads that stop has been requested
-    }
-
-private:
-    queue<T> queue_;
-    mutex mtx_;
-    condition_variable cv_;
-    bool stop_requested_ = false; // Flag to signal threads to stop
-};
-
-// --- Function for the CSV Writer Thread ---
-void csvWriterThread(ThreadSafeQueue<MarketDataTick>& tickQueue, const string& filename) {
-    ofstream outputFile(filename, ios::out | ios::trunc);
-
-    if (!outputFile.is_open()) {
-        cerr << "Error: CSV Writer Thread could not open file " << filename << " for writing." << endl;
-        return;
-    }
-
-    // Write the CSV header row
-    outputFile << "Timestamp,Symbol,Price,Volume\n";
-
-    MarketDataTick tick;
-    try {
-        while (true) {
-            tickQueue.wait_and_pop(tick); // Blocks until a tick is available or stop is requested
-
-            // Write the tick data
-            outputFile << tick.getFormattedTimestamp() << ","
-                       << tick.symbol << ","
-                       << fixed << setprecision(2) << tick.price << ","
-                       << tick.volume << "\n";
-            outputFile.flush(); // Optional: flush buffer to disk more frequently. Good for debugging/recovery.
+        if (isPipelineOption(arg)) {
+            distributed.workerArgs.insert(distributed.workerArgs.end(), argv + first, argv + i + 1);
         }
-    } catch (const runtime_error& e) {
-        // Expected exception when stop is requested and queue is empty
-        cout << "[CSV Writer] Thread stopped: " << e.what() << endl;
-    } catch (const exception& e) {
-        cerr << "[CSV Writer] An unexpected error occurred: " << e.what() << endl;
     }
-
-    outputFile.close();
-    cout << "[CSV Writer] File " << filename << " closed." << endl;
+    return true;
 }
 
-
 // --- Main Application Logic ---
-int main() {
-    // --- Setup Multiple MarketDataGenerators ---
-    vector<MarketDataGenerator> generators;
-    generators.emplace_back("GOOG", 150.00, 1000);
-    generators.emplace_back("AAPL", 175.50, 1200);
-    generators.emplace_back("MSFT", 420.10, 800);
-    generators.emplace_back("AMZN", 180.75, 1500);
-    generators.emplace_back("TSLA", 200.00, 900);
-
-    // --- Setup Thread-Safe Queue and Writer Thread ---
-    ThreadSafeQueue<MarketDataTick> tickQueue;
-    const string filename = "multi_symbol_threaded_market_data_output2.csv";
-
-    // Create and start the writer thread
-    thread writerThread(csvWriterThread, ref(tickQueue), filename);
-
-    cout << "Generating market data for multiple symbols and queuing for writing to "
-              << filename << ". Press Ctrl+C to stop." << endl;
-    cout << "---------------------------------------------------------" << endl;
-    // Console header for immediate feedback
-    cout << left << setw(25) << "Timestamp"
-              << left << setw(10) << "Symbol"
-              << left << setw(15) << "Price"
-              << left << "Volume" << endl;
-    cout << "---------------------------------------------------------" << endl;
-
-    // --- Main Simulation Loop (Producer) ---
-    const int num_simulation_steps = 50; // More steps to see data accumulate
-    const chrono::milliseconds time_step_delay(100); // Shorter delay
+int main(int argc, char* argv[]) {
+    PipelineOptions options;
+    DistributedOptions distributed;
+    string workerOf;
+    vector<string> subscription; // ADDRESS, SYMBOLS
+    bool listOnly = false;
+    string benchmark;
+    string regression;
+    RegressionMode regressionMode = RegressionMode::Full;
+    if (!parseOptions(argc, argv, options, distributed, workerOf, subscription, listOnly, benchmark, regression,
+                      regressionMode)) {
+        printUsage(argv[0]);
+        return 1;
+    }
 
-    for (int step = 0; step < num_simulation_steps; ++step) {
-        for (auto& generator : generators) {
-            MarketDataTick tick = generator.generateTick();
+    if (listOnly) {
+        cout << "Available pipelines:\n";
+        listPipelines(cout);
+        cout << "Available benchmarks:\n";
+        listBenchmarks(cout);
+        return 0;
+    }
+    if (!benchmark.empty()) {
+        return runBenchmark(benchmark);
+    }
+    if (!regression.empty()) {
+        return runRegression(regression, regressionMode);
+    }
+    if (!subscription.empty()) {
+        return runSubscriber(subscription[0], subscription[1]);
+    }
 
-            // Print to console (for real-time observation)
-            cout << fixed << setprecision(2)
-                      << left << setw(25) << tick.getFormattedTimestamp()
-                      << left << setw(10) << tick.symbol
-                      << left << setw(15) << tick.price
-                      << left << tick.volume << endl;
+    const PipelineEntry* pipeline = findPipeline(options.pipeline);
+    if (pipeline == nullptr) {
+        cerr << "Error: unknown pipeline '" << options.pipeline << "'. Available pipelines:\n";
+        listPipelines(cerr);
+        return 1;
+    }
 
-            // Push the tick to the thread-safe queue for the writer thread
-            tickQueue.push(tick);
+    if (options.targetP99Us > 0.0 && options.simulatedClock) {
+        // The controller measures tick timestamp -> flush latency, which needs wall-clock timestamps
+        cerr << "Error: --target-p99-us cannot be combined with --sim-clock." << endl;
+        return 1;
+    }
+    if (distributed.workers > 0) {
+        if (options.partitions > 1) {
+            cerr << "Error: --coordinator shards across processes; it cannot be combined with --partitions." << endl;
+            return 1;
         }
-        this_thread::sleep_for(time_step_delay);
+        return runCoordinator(distributed);
+    }
+    if (!workerOf.empty()) {
+        return runWorker(workerOf, *pipeline, options);
     }
 
-    // --- Shutdown Process ---
-    cout << "\n---------------------------------------------------------" << endl;
-    cout << "Simulation finished. Signaling writer thread to stop..." << endl;
-
-    tickQueue.stop(); // Signal the writer thread to stop processing new items
-
-    writerThread.join(); // Wait for the writer thread to finish its work and terminate
-
-    cout << "All data written and threads joined. Application exiting." << endl;
-
-    return 0;
+    int status = pipeline->run(options);
+    if (status == 0) {
+        cout << "All data written and threads joined. Application exiting." << endl;
+    }
+    return status;
 }
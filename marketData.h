@@ -2,8 +2,13 @@
 #define SIMPLE_MARKET_DATA_H
 
 #include <string>     // For std::string
+#include <algorithm>  // For std::min, std::max
 #include <chrono>     // For std::chrono::system_clock::time_point
+#include <cmath>      // For std::sqrt, std::llround
+#include <cstdint>    // For uint64_t
 #include <random>     // For std::mt19937, std::uniform_real_distribution, std::uniform_int_distribution
+#include <type_traits> // For std::true_type, std::void_t
+#include "gaussian.h" // For ZigguratNormal
 
 // Structure to represent a single market data tick
 struct MarketDataTick {
@@ -12,32 +17,361 @@ struct MarketDataTick {
     double price;
     long volume;
 
+    // "YYYY-MM-DD HH:MM:SS.mmm" local time, written into out (room for fastfmt::kTimestampLength
+    // chars, no terminator); returns the end pointer. Reuses a per-thread formatted second.
+    char* formatTimestamp(char* out) const;
+
     // Declaration of the helper function
     std::string getFormattedTimestamp() const;
 };
 
-// Class to generate simple market data ticks
-class MarketDataGenerator {
+// SplitMix64 finalizer: derives well-spread per-stream seeds from one user seed.
+inline uint64_t mixSeed(uint64_t seed, uint64_t stream) {
+    uint64_t z = seed + 0x9E3779B97F4A7C15ull * (stream + 1);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// --- RNG Jump-Ahead ---
+// RngJump<Rng>::jump(rng, n) leaves rng where n calls would. The default is the engine's own
+// discard(), which is O(n): mt19937 and mt19937_64 still pay about one engine call per skipped
+// call (--bench skip). Linear congruential engines jump in O(log n).
+template <typename Rng>
+struct RngJump {
+    static void jump(Rng& rng, uint64_t n) { rng.discard(n); }
+};
+
+template <typename UInt, UInt A, UInt C, UInt M>
+struct RngJump<std::linear_congruential_engine<UInt, A, C, M>> {
+    static_assert(M != 0, "jump-ahead needs an explicit modulus");
+
+    static void jump(std::linear_congruential_engine<UInt, A, C, M>& rng, uint64_t n) {
+        if (n == 0) {
+            return;
+        }
+        // The output is the state: x1 = rng(), then x_n = f^(n-1)(x1) with f(x) = A x + C mod M
+        using Wide = unsigned __int128;
+        Wide state = rng();
+        Wide mul = A % M, add = C % M; // f^(2^k)
+        for (uint64_t k = n - 1; k != 0; k >>= 1) {
+            if (k & 1) {
+                state = (mul * state + add) % M;
+            }
+            add = (mul * add + add) % M;
+            mul = (mul * mul) % M;
+        }
+        rng.seed(static_cast<UInt>(state));
+    }
+};
+
+// --- Producer-Wide RNG Streams ---
+// A producer holds an RngStream<Rng> for as long as it steps its generators, seeded once per
+// partition. Engines that draw from one stream shared by a whole producer (PrefilledEngine)
+// find it there; for every other engine it is empty and each engine keeps its own state.
+template <typename Rng>
+struct RngStream {
+    explicit RngStream(uint64_t) {}
+};
+
+// --- Counter-Based Engines ---
+// Engines with setStep(step) (e.g. Philox4x32) draw each simulation step from its own stream.
+// Such an engine needs no jump-ahead: a generator just selects the stream of the step it is at.
+template <typename Rng, typename = void>
+struct IsCounterBased : std::false_type {};
+
+template <typename Rng>
+struct IsCounterBased<Rng, std::void_t<decltype(std::declval<Rng&>().setStep(uint64_t()))>> : std::true_type {};
+
+// Seed width of an engine: Rng::seed_type where declared (wider keys), else result_type.
+template <typename Rng, typename = void>
+struct SeedTypeOf {
+    using type = typename Rng::result_type;
+};
+
+template <typename Rng>
+struct SeedTypeOf<Rng, std::void_t<typename Rng::seed_type>> {
+    using type = typename Rng::seed_type;
+};
+
+// Engine calls per std::uniform_real_distribution<double> draw (generate_canonical's k).
+template <typename Rng>
+constexpr uint64_t canonicalCalls() {
+    uint64_t range = static_cast<uint64_t>(Rng::max() - Rng::min());
+    uint64_t bits = 64; // floor(log2(range + 1)), without overflowing for full 64-bit engines
+    if (range != ~0ULL) {
+        for (bits = 0; ((range + 1) >> (bits + 1)) != 0; ++bits) {
+        }
+    }
+    return bits >= 53 ? 1 : (53 + bits - 1) / bits;
+}
+
+// One standard normal for an aggregated skip, drawn from rng, after which rng is left where
+// calls engine calls would leave it: the draw is taken from the skipped words. Counter-based
+// engines are already on the next step's stream and are only drawn from.
+template <typename Rng>
+double drawSkipNormal(Rng& rng, uint64_t calls) {
+    if constexpr (IsCounterBased<Rng>::value) {
+        return ZigguratNormal::draw(rng);
+    } else {
+        Rng start = rng;
+        double normal = ZigguratNormal::draw(rng);
+        rng = start;
+        RngJump<Rng>::jump(rng, calls);
+        return normal;
+    }
+}
+
+// Adds the sum of steps uniform integer increments in [low, high] to volume in one draw: the
+// sum's normal limit, kept within its exact range. Each increment is one engine call (up to
+// rare rejections), so volumeGen is jumped by steps.
+template <typename Rng>
+void skipUniformIncrements(long& volume, uint64_t steps, long low, long high, Rng& volumeGen) {
+    double n = static_cast<double>(steps);
+    double span = static_cast<double>(high - low + 1);
+    double mean = 0.5 * static_cast<double>(low + high) * n;
+    double increments = mean + std::sqrt(n * (span * span - 1.0) / 12.0) * drawSkipNormal(volumeGen, steps);
+    increments = std::min(std::max(increments, static_cast<double>(low) * n), static_cast<double>(high) * n);
+    volume += static_cast<long>(std::llround(increments));
+}
+
+// Price/volume dynamics: bounded uniform random walk on price, uniform increments on volume.
+// Models also implement skip(), which advances the state by many steps with one aggregated draw
+// and leaves the engines where that many step() calls would.
+class RandomWalkModel {
+public:
+    RandomWalkModel() : priceDist_(-0.5, 0.5), volumeDist_(1, 100) {}
+
+    // Engine calls one step() takes from the price stream, so a skipped stream can be jumped in step.
+    template <typename Rng>
+    static constexpr uint64_t priceCallsPerStep() { return canonicalCalls<Rng>(); }
+
+    template <typename Rng>
+    void step(double& price, long& volume, Rng& priceGen, Rng& volumeGen) {
+        price += priceDist_(priceGen) * 0.1;
+        if (price < 0.01) {
+            price = 0.01;
+        }
+
+        volume += volumeDist_(volumeGen);
+        if (volume < 1) {
+            volume = 1;
+        }
+    }
+
+    // Advances the state by steps at once. The sum of steps uniform price moves is drawn from
+    // its normal limit (sd 0.1 * sqrt(steps / 12)), with the floor applied once at the end. The
+    // volume increments are drawn the same way. The result is statistically equivalent to steps
+    // calls of step() for large steps, but it follows a different path.
+    template <typename Rng>
+    void skip(double& price, long& volume, uint64_t steps, Rng& priceGen, Rng& volumeGen) {
+        price += 0.1 * std::sqrt(static_cast<double>(steps) / 12.0) *
+                 drawSkipNormal(priceGen, steps * priceCallsPerStep<Rng>());
+        if (price < 0.01) {
+            price = 0.01;
+        }
+        skipUniformIncrements(volume, steps, 1, 100, volumeGen);
+    }
+
+private:
+    std::uniform_real_distribution<> priceDist_;
+    std::uniform_int_distribution<> volumeDist_;
+};
+
+// Geometric Brownian motion on price: log price moves by drift - volatility^2 / 2 plus
+// volatility times a standard normal each step, so price stays positive and moves in
+// proportion to its level. Volume takes the random walk's uniform increments.
+//
+// Normals come from ZigguratNormal::fill() into a per-generator buffer, refilled every
+// kNormalBuffer steps, so the per-step cost is one load, one exp and one multiply. Counter-based
+// engines draw each step's normal from that step's stream instead, which keeps their
+// (symbol, step) purity. skip() is exact in distribution, because a sum of normals is normal.
+// It sums the normals the skipped steps take from the buffer and from its last refill, and
+// draws only the refills in between as one normal. The buffer and price engine then end where
+// stepping would leave them, except that a ziggurat rejection in a jumped refill would have
+// taken extra engine calls. Gaps that jump no refill (up to the buffered normals plus
+// kNormalBuffer) therefore land on exactly the stepped stream position.
+class GbmModel {
+public:
+    static constexpr size_t kNormalBuffer = 256;
+
+    explicit GbmModel(double drift = 0.0, double volatility = 0.0002)
+        : drift_(drift), volatility_(volatility), volumeDist_(1, 100) {}
+
+    template <typename Rng>
+    void step(double& price, long& volume, Rng& priceGen, Rng& volumeGen) {
+        price *= std::exp(drift_ - 0.5 * volatility_ * volatility_ + volatility_ * nextNormal(priceGen));
+
+        volume += volumeDist_(volumeGen);
+        if (volume < 1) {
+            volume = 1;
+        }
+    }
+
+    template <typename Rng>
+    void skip(double& price, long& volume, uint64_t steps, Rng& priceGen, Rng& volumeGen) {
+        double n = static_cast<double>(steps);
+        double normals;
+        if constexpr (IsCounterBased<Rng>::value) {
+            normals = std::sqrt(n) * ZigguratNormal::draw(priceGen);
+        } else {
+            normals = skipNormals(steps, priceGen);
+        }
+        price *= std::exp((drift_ - 0.5 * volatility_ * volatility_) * n + volatility_ * normals);
+        skipUniformIncrements(volume, steps, 1, 100, volumeGen);
+    }
+
+private:
+    // Sum of the next steps normals nextNormal() would return, leaving the buffer and rng as
+    // those calls would. Whole refills between the buffered and the last one are jumped over
+    // (a fill takes one randomBits64 per normal, ziggurat rejections aside) and their sum is
+    // one normal drawn from the jumped words.
+    template <typename Rng>
+    double skipNormals(uint64_t steps, Rng& rng) {
+        double sum = 0.0;
+        uint64_t buffered = std::min<uint64_t>(steps, kNormalBuffer - nextNormal_);
+        for (uint64_t i = 0; i < buffered; ++i) {
+            sum += normals_[nextNormal_++];
+        }
+        uint64_t fresh = steps - buffered;
+        if (fresh == 0) {
+            return sum;
+        }
+        uint64_t jumped = (fresh - 1) / kNormalBuffer * kNormalBuffer;
+        if (jumped != 0) {
+            sum += std::sqrt(static_cast<double>(jumped)) * drawSkipNormal(rng, jumped * randomBits64Calls<Rng>());
+        }
+        ZigguratNormal::fill(rng, normals_, kNormalBuffer);
+        for (nextNormal_ = 0; nextNormal_ < fresh - jumped; ++nextNormal_) {
+            sum += normals_[nextNormal_];
+        }
+        return sum;
+    }
+
+    template <typename Rng>
+    double nextNormal(Rng& rng) {
+        if constexpr (IsCounterBased<Rng>::value) {
+            return ZigguratNormal::draw(rng);
+        } else {
+            if (nextNormal_ == kNormalBuffer) {
+                ZigguratNormal::fill(rng, normals_, kNormalBuffer);
+                nextNormal_ = 0;
+            }
+            return normals_[nextNormal_++];
+        }
+    }
+
+    double drift_;
+    double volatility_;
+    std::uniform_int_distribution<> volumeDist_;
+    size_t nextNormal_ = kNormalBuffer;
+    double normals_[kNormalBuffer];
+};
+
+// Class to generate simple market data ticks.
+// The RNG engine and price model are template parameters so a pipeline built from a fixed
+// configuration compiles generateTick() into a fully inlined loop.
+template <typename Rng = std::mt19937, typename Model = RandomWalkModel>
+class BasicMarketDataGenerator {
 public:
-    // Constructor declaration
-    MarketDataGenerator(std::string symbol, double initialPrice, long initialVolume);
+    using RngType = Rng;
+    using ModelType = Model;
+
+    // Seeds both engines from std::random_device
+    BasicMarketDataGenerator(std::string symbol, double initialPrice, long initialVolume)
+        : BasicMarketDataGenerator(std::move(symbol), initialPrice, initialVolume,
+                                   std::random_device()(), std::random_device()())
+    {}
+
+    // Deterministic seeding: the same seed always reproduces the same price/volume path
+    BasicMarketDataGenerator(std::string symbol, double initialPrice, long initialVolume, uint64_t seed)
+        : BasicMarketDataGenerator(std::move(symbol), initialPrice, initialVolume,
+                                   mixSeed(seed, 0), mixSeed(seed, 1))
+    {}
 
     // Public getter for the symbol
-    const std::string& getSymbol() const;
+    const std::string& getSymbol() const { return symbol_; }
 
     // Method to generate a single market data tick
-    MarketDataTick generateTick();
+    MarketDataTick generateTick() {
+        MarketDataTick tick;
+        tick.timestamp = simulatedClock_ ? clockStart_ + clockInterval_ * static_cast<int64_t>(step_)
+                                         : std::chrono::system_clock::now();
+        tick.symbol = symbol_;
+
+        selectStep();
+        model_.step(currentPrice_, currentVolume_, priceGen_, volumeGen_);
+        ++step_;
+
+        tick.price = currentPrice_;
+        tick.volume = currentVolume_;
+
+        return tick;
+    }
+
+    // Stamps ticks with simulated time, start + step * interval, instead of the wall clock, so a
+    // seeded run reproduces its output byte for byte (--sim-clock, --regress).
+    void useSimulatedClock(std::chrono::system_clock::time_point start, std::chrono::system_clock::duration interval) {
+        simulatedClock_ = true;
+        clockStart_ = start;
+        clockInterval_ = interval;
+    }
+
+    // Moves the price/volume path on by steps without producing ticks, e.g. for a symbol that
+    // nobody consumed for a while. Short gaps are stepped exactly. Longer ones take one
+    // aggregated Model::skip() draw, then leave the engines where steps exact steps would (see
+    // the models for their limits), so the ticks that follow draw from the same stream positions
+    // as in an unskipped run. Repositioning the engines is RngJump: O(log steps) for linear
+    // congruential engines, O(steps) discard() for the others. Counter-based engines simply
+    // select the next step's stream.
+    static constexpr uint64_t kExactAdvanceSteps = 64;
+
+    void advance(uint64_t steps) {
+        if (steps <= kExactAdvanceSteps) {
+            for (uint64_t i = 0; i < steps; ++i) {
+                selectStep();
+                model_.step(currentPrice_, currentVolume_, priceGen_, volumeGen_);
+                ++step_;
+            }
+            return;
+        }
+        selectStep();
+        model_.skip(currentPrice_, currentVolume_, steps, priceGen_, volumeGen_);
+        step_ += steps;
+    }
 
 private:
+    BasicMarketDataGenerator(std::string symbol, double initialPrice, long initialVolume,
+                             uint64_t priceSeed, uint64_t volumeSeed)
+        : symbol_(std::move(symbol)),
+          currentPrice_(initialPrice),
+          currentVolume_(initialVolume),
+          priceGen_(static_cast<typename SeedTypeOf<Rng>::type>(priceSeed)),
+          volumeGen_(static_cast<typename SeedTypeOf<Rng>::type>(volumeSeed))
+    {}
+
+    void selectStep() {
+        if constexpr (IsCounterBased<Rng>::value) {
+            priceGen_.setStep(step_);
+            volumeGen_.setStep(step_);
+        }
+    }
+
     std::string symbol_;
     double currentPrice_;
     long currentVolume_;
+    uint64_t step_ = 0;         // Steps taken, generated or advanced
+    bool simulatedClock_ = false;
+    std::chrono::system_clock::time_point clockStart_;
+    std::chrono::system_clock::duration clockInterval_{0};
 
-    // Random number generators and distributions
-    std::mt19937 priceGen_;
-    std::mt19937 volumeGen_;
-    std::uniform_real_distribution<> priceDist_;
-    std::uniform_int_distribution<> volumeDist_;
+    // Random number generators and price model
+    Rng priceGen_;
+    Rng volumeGen_;
+    Model model_;
 };
 
+// The original configuration: std::mt19937 engines driving the uniform random walk
+using MarketDataGenerator = BasicMarketDataGenerator<>;
+
 #endif // SIMPLE_MARKET_DATA_H
@@ -0,0 +1,273 @@
+#ifndef MARKET_DATA_MARKET_EVENT_H
+#define MARKET_DATA_MARKET_EVENT_H
+
+#include <chrono>     // For std::chrono::system_clock
+#include <cstdint>    // For int64_t, uint32_t, uint8_t
+#include <cstring>    // For memcpy, memset, strnlen
+#include <stdexcept>  // For std::invalid_argument
+#include <string>     // For std::string
+#include <string_view> // For std::string_view
+#include <type_traits> // For std::is_trivially_copyable
+#include <vector>     // For std::vector
+#include "fastFormat.h" // For fastfmt
+#include "marketData.h" // For MarketDataTick
+#include "tickBatch.h" // For SymbolTable
+
+// --- Compact Tagged Market Event ---
+// One cache line per event whatever its kind, so queues, batches and raw sinks carry mixed
+// trades, quotes and book updates without std::variant bookkeeping or heap allocation:
+//   offset 0  int64   timestamp, nanoseconds since the Unix epoch
+//   offset 8  char[8] symbol, NUL-padded (longer symbols are truncated)
+//   offset 16 uint32  sequence number
+//   offset 20 uint8   EventType discriminator
+//   offset 24 40-byte payload selected by the discriminator
+// New kinds add a payload struct (<= 40 bytes), an EventType value and a visitEvent case.
+enum class EventType : uint8_t {
+    Trade,
+    Quote,
+    BookUpdate,
+    Count // Number of kinds; not a valid discriminator
+};
+
+enum class Side : uint8_t { Buy, Sell };
+enum class BookAction : uint8_t { Insert, Update, Delete };
+
+struct TradePayload {
+    double price;
+    int64_t size;
+    Side aggressor;
+};
+
+struct QuotePayload {
+    double bidPrice;
+    int64_t bidSize;
+    double askPrice;
+    int64_t askSize;
+};
+
+struct BookUpdatePayload {
+    double price;
+    int64_t size;
+    uint16_t level;
+    Side side;
+    BookAction action;
+};
+
+struct alignas(64) MarketEvent {
+    int64_t timestampNs;
+    char symbol[8];
+    uint32_t sequence;
+    EventType type;
+    uint8_t reserved[3];
+    union {
+        TradePayload trade;
+        QuotePayload quote;
+        BookUpdatePayload book;
+    };
+
+    std::chrono::system_clock::time_point timestamp() const {
+        return std::chrono::system_clock::time_point(std::chrono::duration_cast<std::chrono::system_clock::duration>(
+            std::chrono::nanoseconds(timestampNs)));
+    }
+
+    std::string_view symbolView() const { return std::string_view(symbol, strnlen(symbol, sizeof(symbol))); }
+};
+static_assert(sizeof(MarketEvent) == 64, "MarketEvent must stay one cache line");
+static_assert(alignof(MarketEvent) == 64, "MarketEvent must be cache-line aligned");
+static_assert(std::is_trivially_copyable<MarketEvent>::value, "MarketEvent is copied as raw bytes");
+
+namespace mevent {
+
+inline MarketEvent makeHeader(EventType type, int64_t timestampNs, std::string_view symbol, uint32_t sequence) {
+    MarketEvent event;
+    std::memset(&event, 0, sizeof(event)); // Deterministic padding for raw sinks
+    event.timestampNs = timestampNs;
+    std::memcpy(event.symbol, symbol.data(), symbol.size() < sizeof(event.symbol) ? symbol.size() : sizeof(event.symbol));
+    event.sequence = sequence;
+    event.type = type;
+    return event;
+}
+
+inline MarketEvent makeTrade(int64_t timestampNs, std::string_view symbol, uint32_t sequence,
+                             double price, int64_t size, Side aggressor) {
+    MarketEvent event = makeHeader(EventType::Trade, timestampNs, symbol, sequence);
+    event.trade.price = price;
+    event.trade.size = size;
+    event.trade.aggressor = aggressor;
+    return event;
+}
+
+inline MarketEvent makeQuote(int64_t timestampNs, std::string_view symbol, uint32_t sequence,
+                             double bidPrice, int64_t bidSize, double askPrice, int64_t askSize) {
+    MarketEvent event = makeHeader(EventType::Quote, timestampNs, symbol, sequence);
+    event.quote.bidPrice = bidPrice;
+    event.quote.bidSize = bidSize;
+    event.quote.askPrice = askPrice;
+    event.quote.askSize = askSize;
+    return event;
+}
+
+inline MarketEvent makeBookUpdate(int64_t timestampNs, std::string_view symbol, uint32_t sequence,
+                                  Side side, uint16_t level, BookAction action, double price, int64_t size) {
+    MarketEvent event = makeHeader(EventType::BookUpdate, timestampNs, symbol, sequence);
+    event.book.price = price;
+    event.book.size = size;
+    event.book.level = level;
+    event.book.side = side;
+    event.book.action = action;
+    return event;
+}
+
+// The generator's ticks are last-trade prints.
+inline MarketEvent fromTick(const MarketDataTick& tick, uint32_t sequence = 0) {
+    int64_t timestampNs = std::chrono::duration_cast<std::chrono::nanoseconds>(tick.timestamp.time_since_epoch()).count();
+    return makeTrade(timestampNs, tick.symbol, sequence, tick.price, tick.volume, Side::Buy);
+}
+
+} // namespace mevent
+
+// --- Producer-Side Sequencing ---
+// Packer of the event formatters (see DirectPacker in pipeline.h): stamps each generated trade
+// with its symbol's sequence number, 1, 2, ... in generation order, so a consumer can spot
+// per-symbol gaps and duplicates. One per producer; a symbol is only ever generated by one.
+class MarketEventPacker {
+public:
+    explicit MarketEventPacker(const std::vector<std::string>& symbols)
+        : table_(symbols), sequences_(table_.size(), 0) {}
+
+    template <typename Queue>
+    void add(MarketDataTick&& tick, Queue& queue) {
+        queue.push(mevent::fromTick(tick, ++sequences_[symbolId(tick.symbol)]));
+    }
+
+    template <typename Queue>
+    void flush(Queue&) {}
+
+private:
+    // Generators tick in universe order, so the next id is almost always the previous one + 1.
+    uint32_t symbolId(const std::string& symbol) {
+        uint32_t id = nextId_;
+        if (id >= table_.size() || table_.name(id) != symbol) {
+            id = table_.idOf(symbol);
+        }
+        nextId_ = id + 1 < table_.size() ? id + 1 : 0;
+        return id;
+    }
+
+    SymbolTable table_;
+    std::vector<uint32_t> sequences_; // By symbol id: the last sequence number stamped
+    uint32_t nextId_ = 0;
+};
+
+// Calls visitor(event, payload) with the payload matching event.type, inlined into a dense
+// switch (every overload must return the same type); an unknown type throws std::invalid_argument.
+template <typename Visitor>
+decltype(auto) visitEvent(Visitor&& visitor, const MarketEvent& event) {
+    static_assert(static_cast<size_t>(EventType::Count) == 3, "visitEvent: add a case for the new EventType");
+    if (__builtin_expect(static_cast<uint8_t>(event.type) >= static_cast<uint8_t>(EventType::Count), 0)) {
+        throw std::invalid_argument("MarketEvent has an unknown type");
+    }
+    switch (event.type) {
+    case EventType::Trade:
+        return visitor(event, event.trade);
+    case EventType::Quote:
+        return visitor(event, event.quote);
+    default:
+        return visitor(event, event.book);
+    }
+}
+
+// --- Market Event Formatters ---
+// CSV rows whose trailing fields depend on the event kind:
+//   timestamp,symbol,TRADE,price,size,B|S
+//   timestamp,symbol,QUOTE,bidPrice,bidSize,askPrice,askSize
+//   timestamp,symbol,BOOK,B|S,level,INSERT|UPDATE|DELETE,price,size
+struct MarketEventCsvFormatter {
+    using Item = MarketEvent;
+
+    using Packer = MarketEventPacker;
+    static std::chrono::system_clock::time_point timestampOf(const Item& event) { return event.timestamp(); }
+    static std::string_view symbolOf(const Item& event) { return event.symbolView(); }
+    static const char* header() { return "Timestamp,Symbol,Event,Fields\n"; }
+
+    // Timestamp + symbol + tag + up to four numbers (24 each) + short fields and separators
+    static size_t maxRecordSize(const Item&) { return 192; }
+
+    char* format(const Item& event, char* out) {
+        out = fastfmt::writeTimestamp(event.timestamp(), out);
+        *out++ = ',';
+        std::string_view symbol = event.symbolView();
+        std::memcpy(out, symbol.data(), symbol.size());
+        out += symbol.size();
+        return visitEvent(FieldWriter{out}, event);
+    }
+
+private:
+    static char* writeText(const char* text, char* out) {
+        size_t length = std::strlen(text);
+        std::memcpy(out, text, length);
+        return out + length;
+    }
+
+    struct FieldWriter {
+        char* out;
+
+        char* operator()(const MarketEvent&, const TradePayload& trade) {
+            out = writeText(",TRADE,", out);
+            out = fastfmt::writeFixed<2>(trade.price, out);
+            *out++ = ',';
+            out = fastfmt::writeSigned(trade.size, out);
+            *out++ = ',';
+            *out++ = trade.aggressor == Side::Buy ? 'B' : 'S';
+            *out++ = '\n';
+            return out;
+        }
+
+        char* operator()(const MarketEvent&, const QuotePayload& quote) {
+            out = writeText(",QUOTE,", out);
+            out = fastfmt::writeFixed<2>(quote.bidPrice, out);
+            *out++ = ',';
+            out = fastfmt::writeSigned(quote.bidSize, out);
+            *out++ = ',';
+            out = fastfmt::writeFixed<2>(quote.askPrice, out);
+            *out++ = ',';
+            out = fastfmt::writeSigned(quote.askSize, out);
+            *out++ = '\n';
+            return out;
+        }
+
+        char* operator()(const MarketEvent&, const BookUpdatePayload& book) {
+            static const char* const kActions[] = {"INSERT", "UPDATE", "DELETE"};
+            out = writeText(",BOOK,", out);
+            *out++ = book.side == Side::Buy ? 'B' : 'S';
+            *out++ = ',';
+            out = fastfmt::writeUnsigned(book.level, out);
+            *out++ = ',';
+            out = writeText(kActions[static_cast<size_t>(book.action) % 3], out);
+            *out++ = ',';
+            out = fastfmt::writeFixed<2>(book.price, out);
+            *out++ = ',';
+            out = fastfmt::writeSigned(book.size, out);
+            *out++ = '\n';
+            return out;
+        }
+    };
+};
+
+// Raw 64-byte events (host byte order), no header; pairs with VectoredFileSink.
+struct MarketEventRecordFormatter {
+    using Item = MarketEvent;
+
+    using Packer = MarketEventPacker;
+    static std::chrono::system_clock::time_point timestampOf(const Item& event) { return event.timestamp(); }
+    static std::string_view symbolOf(const Item& event) { return event.symbolView(); }
+    static const char* header() { return ""; }
+    static size_t maxRecordSize(const Item&) { return sizeof(Item); }
+
+    char* format(const Item& event, char* out) {
+        std::memcpy(out, &event, sizeof(event));
+        return out + sizeof(event);
+    }
+};
+
+#endif // MARKET_DATA_MARKET_EVENT_H
@@ -0,0 +1,168 @@
+#ifndef MARKET_DATA_MMAP_SINK_H
+#define MARKET_DATA_MMAP_SINK_H
+
+#include <algorithm>  // For std::max, std::min
+#include <cerrno>     // For errno
+#include <cstring>    // For memcpy, strerror, strlen
+#include <stdexcept>  // For std::runtime_error
+#include <string>     // For std::string
+#include <vector>     // For std::vector
+#include <fcntl.h>    // For open, fallocate
+#include <sys/mman.h> // For mmap, munmap, madvise, msync
+#include <unistd.h>   // For ftruncate, close, sysconf
+
+// --- Memory-Mapped File Sink ---
+// Appends by formatting straight into a shared mapping of the output file, so the writer
+// thread makes no write syscalls per record or batch; the only syscalls come when a window is
+// retired and at close(). The first window is small (firstWindowBytes) and each next one doubles
+// up to kMaxWindowBytes, so short runs preallocate a few MB and long runs still remap rarely.
+// The file is extended with fallocate one window ahead, each window is mapped with
+// MADV_SEQUENTIAL, and a retired window is handed to writeback with an async msync before being
+// unmapped. flush() does nothing: data in a shared mapping is already visible to readers.
+// close() trims the preallocated tail. If the process dies before close(), the file keeps a
+// zero-filled tail.
+//
+// Where fallocate is not supported the file is extended sparsely with ftruncate instead. Blocks
+// are then allocated on page faults, and if the filesystem is full the faulting write raises
+// SIGBUS, which ends the process rather than surfacing as a write error.
+template <typename Formatter>
+class MmapSink {
+public:
+    using Item = typename Formatter::Item;
+    static constexpr size_t kFirstWindowBytes = size_t{1} << 20;
+    static constexpr size_t kMaxWindowBytes = size_t{256} << 20;
+
+    MmapSink(const std::string& path, Formatter&, size_t firstWindowBytes = kFirstWindowBytes)
+        : fd_(::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644)),
+          pageSize_(static_cast<size_t>(sysconf(_SC_PAGESIZE))),
+          // A new window starts at the page holding the write position, so it must span many pages
+          windowBytes_(roundUp(std::max(firstWindowBytes, 16 * pageSize_), pageSize_))
+    {
+        if (fd_ < 0) {
+            return;
+        }
+        try {
+            mapWindowAt(0);
+        } catch (const std::runtime_error&) {
+            ::close(fd_);
+            fd_ = -1; // Reported by the pipeline as an open failure
+            return;
+        }
+        const char* header = Formatter::header();
+        size_t headerLength = std::strlen(header);
+        std::memcpy(window_, header, headerLength);
+        cursor_ += headerLength;
+    }
+
+    ~MmapSink() {
+        try {
+            close();
+        } catch (const std::exception&) {
+            // Destructors must not throw; the writer already reported the failure
+        }
+    }
+
+    MmapSink(const MmapSink&) = delete;
+    MmapSink& operator=(const MmapSink&) = delete;
+
+    bool isOpen() const { return fd_ >= 0; }
+
+    void writeBatch(std::vector<Item>& batch, Formatter& formatter) {
+        for (const Item& item : batch) {
+            size_t needed = Formatter::maxRecordSize(item);
+            if (cursor_ + needed > windowBytes_) {
+                advanceWindow();
+            }
+            char* end = formatter.format(item, window_ + cursor_);
+            cursor_ = static_cast<size_t>(end - window_);
+        }
+    }
+
+    // Data in a shared mapping is already visible to readers; writeback starts as windows retire.
+    void flush() {}
+
+    void close() {
+        if (fd_ < 0) {
+            return;
+        }
+        uint64_t length = windowOffset_ + cursor_;
+        unmapWindow();
+        if (ftruncate(fd_, static_cast<off_t>(length)) != 0) {
+            ::close(fd_);
+            fd_ = -1;
+            throw std::runtime_error(std::string("ftruncate failed: ") + std::strerror(errno));
+        }
+        ::close(fd_);
+        fd_ = -1;
+    }
+
+private:
+    static size_t roundUp(size_t value, size_t multiple) {
+        return (value + multiple - 1) / multiple * multiple;
+    }
+
+    // Makes sure the file is backed up to `end` bytes, preferring real block allocation.
+    void ensureAllocated(uint64_t end) {
+        if (end <= allocated_) {
+            return;
+        }
+#if defined(__linux__)
+        if (fallocate(fd_, 0, static_cast<off_t>(allocated_), static_cast<off_t>(end - allocated_)) == 0) {
+            allocated_ = end;
+            return;
+        }
+        // Filesystems without fallocate (e.g. some tmpfs/overlay setups): sparse extension.
+        // Blocks are then allocated on page faults; ENOSPC at that point is a SIGBUS.
+#endif
+        if (ftruncate(fd_, static_cast<off_t>(end)) != 0) {
+            throw std::runtime_error(std::string("could not extend output file: ") + std::strerror(errno));
+        }
+        allocated_ = end;
+    }
+
+    size_t nextWindowBytes() const { return std::min(windowBytes_ * 2, std::max(windowBytes_, kMaxWindowBytes)); }
+
+    void mapWindowAt(uint64_t offset) {
+        // Preallocate this window and the next so the kernel never allocates blocks on a page fault
+        ensureAllocated(offset + windowBytes_ + nextWindowBytes());
+        void* mapping = mmap(nullptr, windowBytes_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, static_cast<off_t>(offset));
+        if (mapping == MAP_FAILED) {
+            throw std::runtime_error(std::string("mmap failed: ") + std::strerror(errno));
+        }
+        madvise(mapping, windowBytes_, MADV_SEQUENTIAL);
+        window_ = static_cast<char*>(mapping);
+        windowOffset_ = offset;
+        cursor_ = 0;
+    }
+
+    // Starts writeback of the window's written pages, then drops the mapping.
+    void unmapWindow() {
+        if (window_ != nullptr) {
+            if (cursor_ != 0) {
+                msync(window_, cursor_, MS_ASYNC);
+            }
+            munmap(window_, windowBytes_);
+            window_ = nullptr;
+        }
+    }
+
+    // Continue in a new, larger window starting at the page that holds the current write position.
+    void advanceWindow() {
+        uint64_t position = windowOffset_ + cursor_;
+        uint64_t alignedStart = position - position % pageSize_;
+        unmapWindow();
+        windowBytes_ = nextWindowBytes();
+        mapWindowAt(alignedStart);
+        cursor_ = static_cast<size_t>(position - alignedStart);
+    }
+
+    int fd_;
+    size_t pageSize_;
+    size_t windowBytes_;        // Of the current window; doubles per window up to kMaxWindowBytes
+    char* window_ = nullptr;
+    uint64_t windowOffset_ = 0; // File offset of window_[0] (page aligned)
+    size_t cursor_ = 0;         // Next write position within the window
+    uint64_t allocated_ = 0;    // File bytes backed by fallocate/ftruncate
+};
+
+#endif // MARKET_DATA_MMAP_SINK_H
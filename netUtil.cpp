@@ -0,0 +1,188 @@
+#include "netUtil.h"
+#include <cerrno>     // For errno, EINTR
+#include <cstring>    // For strerror, memcpy
+#include <stdexcept>  // For runtime_error, invalid_argument
+
+#include <fcntl.h>    // For fcntl, O_NONBLOCK
+#include <netdb.h>    // For getaddrinfo
+#include <sys/socket.h> // For socket, bind, listen, connect, send, recv
+#include <sys/stat.h> // For stat, S_ISSOCK
+#include <sys/un.h>   // For sockaddr_un
+#include <unistd.h>   // For close, unlink
+
+using namespace std;
+
+namespace net {
+
+namespace {
+
+[[noreturn]] void throwSystemError(const string& what) {
+    throw runtime_error(what + ": " + strerror(errno));
+}
+
+sockaddr_un unixAddress(const string& path) {
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    return address;
+}
+
+// Calls open(fd, address) (bind or connect) on each resolved TCP address until one succeeds.
+template <typename Open>
+int openTcp(const Endpoint& endpoint, bool passive, Open open) {
+    addrinfo hints = {};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = passive ? AI_PASSIVE : 0;
+    addrinfo* addresses = nullptr;
+    int error = getaddrinfo(endpoint.host.empty() ? nullptr : endpoint.host.c_str(), endpoint.port.c_str(), &hints,
+                            &addresses);
+    if (error != 0) {
+        throw runtime_error("cannot resolve " + endpoint.host + ":" + endpoint.port + ": " + gai_strerror(error));
+    }
+    int fd = -1;
+    for (addrinfo* address = addresses; address != nullptr && fd < 0; address = address->ai_next) {
+        fd = socket(address->ai_family, address->ai_socktype | SOCK_CLOEXEC, address->ai_protocol);
+        if (fd >= 0 && !open(fd, address->ai_addr, address->ai_addrlen)) {
+            close(fd);
+            fd = -1;
+        }
+    }
+    freeaddrinfo(addresses);
+    if (fd < 0) {
+        throwSystemError("cannot open " + endpoint.host + ":" + endpoint.port);
+    }
+    return fd;
+}
+
+} // namespace
+
+// --- Endpoints ---
+Endpoint parseEndpoint(const string& text) {
+    Endpoint endpoint;
+    if (text.compare(0, 5, "unix:") == 0) {
+        endpoint.path = text.substr(5);
+    } else if (text.find('/') != string::npos || text.find(':') == string::npos) {
+        endpoint.path = text;
+    } else {
+        size_t colon = text.find_last_of(':');
+        endpoint.tcp = true;
+        endpoint.host = text.substr(0, colon);
+        endpoint.port = text.substr(colon + 1);
+    }
+    if (!endpoint.tcp && (endpoint.path.empty() || endpoint.path.size() >= sizeof(sockaddr_un::sun_path))) {
+        throw invalid_argument("invalid Unix socket path: " + text);
+    }
+    return endpoint;
+}
+
+int listenOn(const Endpoint& endpoint) {
+    auto bindAndListen = [](int fd, const sockaddr* address, socklen_t length) {
+        int reuse = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        return bind(fd, address, length) == 0 && listen(fd, SOMAXCONN) == 0;
+    };
+    if (endpoint.tcp) {
+        return openTcp(endpoint, true, bindAndListen);
+    }
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        throwSystemError("socket");
+    }
+    struct stat existing = {};
+    if (stat(endpoint.path.c_str(), &existing) == 0 && S_ISSOCK(existing.st_mode)) {
+        unlink(endpoint.path.c_str()); // A stale socket from an earlier run would make bind fail
+    }
+    sockaddr_un address = unixAddress(endpoint.path);
+    if (!bindAndListen(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address))) {
+        int savedErrno = errno;
+        close(fd);
+        errno = savedErrno;
+        throwSystemError("cannot listen on " + endpoint.path);
+    }
+    return fd;
+}
+
+int connectTo(const Endpoint& endpoint) {
+    auto connectOne = [](int fd, const sockaddr* address, socklen_t length) {
+        return connect(fd, address, length) == 0;
+    };
+    if (endpoint.tcp) {
+        return openTcp(endpoint, false, connectOne);
+    }
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        throwSystemError("socket");
+    }
+    sockaddr_un address = unixAddress(endpoint.path);
+    if (!connectOne(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address))) {
+        int savedErrno = errno;
+        close(fd);
+        errno = savedErrno;
+        throwSystemError("cannot connect to " + endpoint.path);
+    }
+    return fd;
+}
+
+// --- Line Protocol ---
+bool sendLine(int fd, const string& line) {
+    string message = line + '\n';
+    size_t sent = 0;
+    while (sent < message.size()) {
+        ssize_t n = send(fd, message.data() + sent, message.size() - sent, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        sent += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+void setNonBlocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    if (flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0) {
+        throwSystemError("fcntl");
+    }
+}
+
+// --- Line Reader ---
+bool LineReader::fill() {
+    char chunk[4096];
+    ssize_t n;
+    do {
+        n = recv(fd_, chunk, sizeof(chunk), 0);
+    } while (n < 0 && errno == EINTR);
+    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+        return true;
+    }
+    if (n <= 0) {
+        return false;
+    }
+    buffer_.append(chunk, static_cast<size_t>(n));
+    return true;
+}
+
+bool LineReader::nextLine(string& line) {
+    size_t newline = buffer_.find('\n');
+    if (newline == string::npos) {
+        return false;
+    }
+    size_t length = newline > 0 && buffer_[newline - 1] == '\r' ? newline - 1 : newline;
+    line.assign(buffer_, 0, length);
+    buffer_.erase(0, newline + 1);
+    return true;
+}
+
+bool LineReader::readLine(string& line) {
+    while (!nextLine(line)) {
+        if (!fill()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace net
@@ -0,0 +1,54 @@
+#ifndef MARKET_DATA_NET_UTIL_H
+#define MARKET_DATA_NET_UTIL_H
+
+#include <string>     // For std::string
+
+// Stream socket helpers shared by the coordinator and the network sinks. Addresses are
+// "unix:PATH" or anything containing '/' for a Unix socket, otherwise "HOST:PORT" over TCP
+// (an empty HOST listens on every interface). Failures throw std::runtime_error.
+namespace net {
+
+struct Endpoint {
+    bool tcp = false;
+    std::string path;
+    std::string host;
+    std::string port;
+};
+
+// Throws std::invalid_argument for a malformed address.
+Endpoint parseEndpoint(const std::string& text);
+
+// Bound, listening socket (close-on-exec). A stale Unix socket file is replaced; other files never are.
+int listenOn(const Endpoint& endpoint);
+int connectTo(const Endpoint& endpoint);
+
+void setNonBlocking(int fd);
+
+// Sends line plus '\n' on a blocking socket; false if the peer is gone.
+bool sendLine(int fd, const std::string& line);
+
+// Buffers a stream socket's input and splits it into lines.
+class LineReader {
+public:
+    explicit LineReader(int fd) : fd_(fd) {}
+
+    // Reads what is available (blocking until something is, unless the socket is non-blocking);
+    // false on EOF or error. A non-blocking socket with nothing to read returns true.
+    bool fill();
+
+    // Next complete line already buffered, without the newline (or a trailing '\r').
+    bool nextLine(std::string& line);
+
+    // Blocks until a full line arrives; false if the peer went away first.
+    bool readLine(std::string& line);
+
+    size_t buffered() const { return buffer_.size(); }
+
+private:
+    int fd_;
+    std::string buffer_;
+};
+
+} // namespace net
+
+#endif // MARKET_DATA_NET_UTIL_H
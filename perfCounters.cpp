@@ -0,0 +1,224 @@
+#include "perfCounters.h"
+#include <iomanip>    // For fixed, setprecision, setw
+#include <mutex>      // For mutex
+#include <vector>     // For vector
+
+#if MDS_ENABLE_PERF_COUNTERS && defined(__linux__)
+#include <cerrno>     // For errno
+#include <cstring>    // For strerror, memset
+#include <linux/perf_event.h> // For perf_event_attr
+#include <sys/ioctl.h> // For ioctl
+#include <sys/syscall.h> // For SYS_perf_event_open
+#include <unistd.h>   // For syscall, read, close
+#define MDS_PERF_COUNTERS_SUPPORTED 1
+#else
+#define MDS_PERF_COUNTERS_SUPPORTED 0
+#endif
+
+using namespace std;
+
+namespace perf {
+
+namespace {
+
+#if MDS_ENABLE_PERF_COUNTERS
+struct StageResult {
+    string stage;
+    PerfCounts counts;
+    uint64_t ticks;
+    string error;
+};
+
+mutex& resultsMutex() {
+    static mutex mtx;
+    return mtx;
+}
+
+vector<StageResult>& results() {
+    static vector<StageResult> stages;
+    return stages;
+}
+#endif
+
+#if MDS_PERF_COUNTERS_SUPPORTED
+struct EventSpec {
+    uint32_t type;
+    uint64_t config;
+};
+
+// Order matches the slots in PerfCounterGroup: cycles, instructions, cache misses, L1D misses, branch misses.
+const EventSpec kEvents[] = {
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                             (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+};
+
+int openEvent(const EventSpec& spec, int groupFd) {
+    perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = spec.type;
+    attr.config = spec.config;
+    attr.disabled = groupFd == -1 ? 1 : 0; // Only the leader starts disabled; members follow it
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    // pid 0 / cpu -1: measure the calling thread on whichever CPU it runs.
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, groupFd, 0));
+}
+#endif
+
+} // namespace
+
+PerfCounterGroup::PerfCounterGroup() {
+#if MDS_PERF_COUNTERS_SUPPORTED
+    for (int i = 0; i < kMaxEvents; ++i) {
+        int fd = openEvent(kEvents[i], leaderFd_);
+        if (fd < 0) {
+            if (leaderFd_ < 0) {
+                error_ = string("perf_event_open failed: ") + strerror(errno) +
+                         " (check /proc/sys/kernel/perf_event_paranoid)";
+                return;
+            }
+            continue; // Unsupported secondary event; keep the rest of the group
+        }
+        if (leaderFd_ < 0) {
+            leaderFd_ = fd;
+        }
+        fds_[i] = fd;
+        slot_[i] = opened_++;
+    }
+#else
+    error_ = "hardware counters not compiled in (configure with -DMDS_ENABLE_PERF_COUNTERS=ON on Linux)";
+#endif
+}
+
+PerfCounterGroup::~PerfCounterGroup() {
+#if MDS_PERF_COUNTERS_SUPPORTED
+    for (int fd : fds_) {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+#endif
+}
+
+void PerfCounterGroup::start() {
+#if MDS_PERF_COUNTERS_SUPPORTED
+    if (available()) {
+        ioctl(leaderFd_, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(leaderFd_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+#endif
+}
+
+void PerfCounterGroup::stop() {
+#if MDS_PERF_COUNTERS_SUPPORTED
+    if (available()) {
+        ioctl(leaderFd_, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+    }
+#endif
+}
+
+PerfCounts PerfCounterGroup::read() const {
+    PerfCounts counts;
+#if MDS_PERF_COUNTERS_SUPPORTED
+    if (!available()) {
+        return counts;
+    }
+
+    // Layout for PERF_FORMAT_GROUP with both time fields: nr, time_enabled, time_running, values[nr].
+    uint64_t buffer[3 + kMaxEvents] = {};
+    if (::read(leaderFd_, buffer, sizeof(buffer)) < static_cast<ssize_t>(3 * sizeof(uint64_t))) {
+        return counts;
+    }
+    uint64_t enabled = buffer[1];
+    uint64_t running = buffer[2];
+    double scale = 1.0;
+    if (running > 0 && running < enabled) {
+        scale = static_cast<double>(enabled) / static_cast<double>(running);
+        counts.multiplexed = true;
+    }
+
+    auto value = [&](int event, uint64_t& out, bool& has) {
+        if (slot_[event] >= 0 && static_cast<uint64_t>(slot_[event]) < buffer[0]) {
+            out = static_cast<uint64_t>(static_cast<double>(buffer[3 + slot_[event]]) * scale);
+            has = true;
+        }
+    };
+    value(0, counts.cycles, counts.hasCycles);
+    value(1, counts.instructions, counts.hasInstructions);
+    value(2, counts.cacheMisses, counts.hasCacheMisses);
+    value(3, counts.l1dMisses, counts.hasL1dMisses);
+    value(4, counts.branchMisses, counts.hasBranchMisses);
+#endif
+    return counts;
+}
+
+void recordStage(const string& stage, const PerfCounterGroup& group, uint64_t ticks) {
+#if MDS_ENABLE_PERF_COUNTERS
+    StageResult result{stage, group.read(), ticks, group.available() ? "" : group.error()};
+    lock_guard<mutex> lock(resultsMutex());
+    results().push_back(move(result));
+#else
+    (void)stage;
+    (void)group;
+    (void)ticks;
+#endif
+}
+
+void printReport(ostream& out) {
+#if MDS_ENABLE_PERF_COUNTERS
+    lock_guard<mutex> lock(resultsMutex());
+    if (results().empty()) {
+        return;
+    }
+
+    out << "\n--- Hardware counters per pipeline stage ---" << endl;
+    out << left << setw(12) << "Stage"
+        << right << setw(10) << "Ticks"
+        << setw(8) << "IPC"
+        << setw(14) << "Cycles/tick"
+        << setw(14) << "Cache/tick"
+        << setw(14) << "L1D/tick"
+        << setw(14) << "Branch/tick" << endl;
+
+    for (const auto& result : results()) {
+        out << left << setw(12) << result.stage;
+        if (!result.error.empty()) {
+            out << " unavailable: " << result.error << endl;
+            continue;
+        }
+
+        const PerfCounts& c = result.counts;
+        double ticks = result.ticks > 0 ? static_cast<double>(result.ticks) : 1.0;
+        auto perTick = [&](bool has, uint64_t value) {
+            if (has) {
+                out << setw(14) << static_cast<double>(value) / ticks;
+            } else {
+                out << setw(14) << "n/a";
+            }
+        };
+
+        out << right << setw(10) << result.ticks << fixed << setprecision(2);
+        if (c.hasCycles && c.hasInstructions && c.cycles > 0) {
+            out << setw(8) << static_cast<double>(c.instructions) / static_cast<double>(c.cycles);
+        } else {
+            out << setw(8) << "n/a";
+        }
+        perTick(c.hasCycles, c.cycles);
+        perTick(c.hasCacheMisses, c.cacheMisses);
+        perTick(c.hasL1dMisses, c.l1dMisses);
+        perTick(c.hasBranchMisses, c.branchMisses);
+        out << (c.multiplexed ? "  (scaled)" : "") << endl;
+    }
+    results().clear(); // The next run in this process (e.g. --regress) reports only its own stages
+#else
+    (void)out;
+#endif
+}
+
+} // namespace perf
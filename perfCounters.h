@@ -0,0 +1,64 @@
+#ifndef MARKET_DATA_PERF_COUNTERS_H
+#define MARKET_DATA_PERF_COUNTERS_H
+
+#include <cstdint>    // For uint64_t
+#include <ostream>    // For std::ostream
+#include <string>     // For std::string
+
+// Optional hardware counter support via perf_event_open (Linux only).
+// When disabled the classes below compile to no-ops and nothing is reported.
+#ifndef MDS_ENABLE_PERF_COUNTERS
+#define MDS_ENABLE_PERF_COUNTERS 0
+#endif
+
+namespace perf {
+
+// Counts accumulated by one PerfCounterGroup. A value is only meaningful if its has* flag is set.
+struct PerfCounts {
+    uint64_t cycles = 0;
+    uint64_t instructions = 0;
+    uint64_t cacheMisses = 0;
+    uint64_t l1dMisses = 0;
+    uint64_t branchMisses = 0;
+    bool hasCycles = false;
+    bool hasInstructions = false;
+    bool hasCacheMisses = false;
+    bool hasL1dMisses = false;
+    bool hasBranchMisses = false;
+    bool multiplexed = false; // Counts were scaled because the kernel time-shared the PMU
+};
+
+// Counter group for the calling thread. Construct and use it on the thread being measured.
+class PerfCounterGroup {
+public:
+    PerfCounterGroup();
+    ~PerfCounterGroup();
+    PerfCounterGroup(const PerfCounterGroup&) = delete;
+    PerfCounterGroup& operator=(const PerfCounterGroup&) = delete;
+
+    bool available() const { return leaderFd_ >= 0; }
+    const std::string& error() const { return error_; }
+
+    void start();
+    void stop();
+    PerfCounts read() const;
+
+private:
+    static constexpr int kMaxEvents = 5;
+
+    int leaderFd_ = -1;
+    int fds_[kMaxEvents] = {-1, -1, -1, -1, -1};
+    int slot_[kMaxEvents] = {-1, -1, -1, -1, -1}; // Position of each event in the group read buffer
+    int opened_ = 0;
+    std::string error_;
+};
+
+// Collects per-stage results from pipeline threads so they can be reported once at the end of a run.
+// Call after group.stop(); a group that failed to open is reported with its error.
+void recordStage(const std::string& stage, const PerfCounterGroup& group, uint64_t ticks);
+// Prints and then discards the stages recorded so far, so each run reports only its own.
+void printReport(std::ostream& out);
+
+} // namespace perf
+
+#endif // MARKET_DATA_PERF_COUNTERS_H
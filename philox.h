@@ -0,0 +1,96 @@
+#ifndef MARKET_DATA_PHILOX_H
+#define MARKET_DATA_PHILOX_H
+
+#include <array>      // For std::array
+#include <cstdint>    // For uint32_t, uint64_t
+#include <limits>     // For std::numeric_limits
+
+// --- Philox4x32-10 Counter-Based Engine ---
+// Salmon et al., "Parallel Random Numbers: As Easy as 1, 2, 3" (SC'11). Each 128-bit counter is
+// mapped to four 32-bit outputs by ten rounds of multiply/xor under a 64-bit key. The mapping is
+// a pure function, so output n of a stream is computed directly, without running through
+// outputs 0..n-1.
+//
+// The counter is laid out as (block lo, block hi, step lo, step hi). setStep(s) selects the
+// stream of simulation step s, so the draws of (symbol key, step) are the same whichever thread
+// computes them and in whatever order. BasicMarketDataGenerator calls setStep before every step.
+// Blocks are independent, so a batch of them has no loop-carried state and can be vectorized.
+// Satisfies UniformRandomBitGenerator, so it works with every <random> distribution.
+class Philox4x32 {
+public:
+    using result_type = uint32_t;
+    using seed_type = uint64_t; // The full 64-bit key (see SeedTypeOf in marketData.h)
+    using Block = std::array<uint32_t, 4>;
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    explicit Philox4x32(uint64_t key = 0) { seed(key); }
+
+    void seed(uint64_t key) {
+        key_ = {static_cast<uint32_t>(key), static_cast<uint32_t>(key >> 32)};
+        setStep(0);
+    }
+
+    // Restarts at the first output of step's stream.
+    void setStep(uint64_t step) {
+        step_ = step;
+        nextBlock_ = 0;
+        index_ = 4;
+    }
+
+    result_type operator()() {
+        if (index_ == 4) {
+            refill();
+        }
+        return buffer_[index_++];
+    }
+
+    // O(1): only the block holding the new position is computed.
+    void discard(uint64_t n) {
+        uint64_t buffered = 4 - index_;
+        if (n < buffered) {
+            index_ += static_cast<uint32_t>(n);
+            return;
+        }
+        n -= buffered;
+        nextBlock_ += n / 4;
+        index_ = 4;
+        if (n % 4 != 0) {
+            refill();
+            index_ = static_cast<uint32_t>(n % 4);
+        }
+    }
+
+    // The ten-round bijection itself.
+    static Block block(Block counter, std::array<uint32_t, 2> key) {
+        for (int round = 0; round < 10; ++round) {
+            if (round > 0) {
+                key[0] += 0x9E3779B9; // Weyl key schedule
+                key[1] += 0xBB67AE85;
+            }
+            uint64_t product0 = uint64_t(0xD2511F53) * counter[0];
+            uint64_t product1 = uint64_t(0xCD9E8D57) * counter[2];
+            counter = {static_cast<uint32_t>(product1 >> 32) ^ counter[1] ^ key[0], static_cast<uint32_t>(product1),
+                       static_cast<uint32_t>(product0 >> 32) ^ counter[3] ^ key[1], static_cast<uint32_t>(product0)};
+        }
+        return counter;
+    }
+
+private:
+    void refill() {
+        buffer_ = block({static_cast<uint32_t>(nextBlock_), static_cast<uint32_t>(nextBlock_ >> 32),
+                         static_cast<uint32_t>(step_), static_cast<uint32_t>(step_ >> 32)},
+                        key_);
+        ++nextBlock_;
+        index_ = 0;
+    }
+
+    std::array<uint32_t, 2> key_;
+    uint64_t step_ = 0;
+    uint64_t nextBlock_ = 0; // Block after the buffered one
+    Block buffer_ = {};
+    uint32_t index_ = 4;     // Next unread output in buffer_; 4 = empty
+};
+
+#endif // MARKET_DATA_PHILOX_H
@@ -0,0 +1,106 @@
+#include "pipeline.h"
+#include <iomanip>    // For fixed, setprecision, setw
+#include <sstream>    // For ostringstream
+#include <stdexcept>  // For out_of_range
+
+using namespace std;
+
+vector<SymbolSpec> defaultUniverse() {
+    return {
+        {"GOOG", 150.00, 1000},
+        {"AAPL", 175.50, 1200},
+        {"MSFT", 420.10, 800},
+        {"AMZN", 180.75, 1500},
+        {"TSLA", 200.00, 900},
+    };
+}
+
+vector<SymbolSpec> makeUniverse(size_t count) {
+    vector<SymbolSpec> universe = defaultUniverse();
+    if (count == 0) {
+        return universe;
+    }
+    if (count > kMaxUniverseSymbols) {
+        throw out_of_range("at most " + to_string(kMaxUniverseSymbols) + " symbols are supported");
+    }
+    if (count < universe.size()) {
+        universe.resize(count);
+    }
+    universe.reserve(count);
+    for (size_t i = universe.size(); i < count; ++i) {
+        string symbol = "S0000000"; // Seven digits: i < kMaxUniverseSymbols
+        for (size_t digits = i, pos = symbol.size() - 1; digits != 0; digits /= 10, --pos) {
+            symbol[pos] = static_cast<char>('0' + digits % 10);
+        }
+        universe.push_back({symbol, 10.0 + static_cast<double>(i * 37 % 490), 1000});
+    }
+    return universe;
+}
+
+size_t partitionOf(const string& symbol, size_t partitionCount) {
+    return partitionCount > 1 ? hash<string>()(symbol) % partitionCount : 0;
+}
+
+string partitionOutput(const string& output, size_t partition) {
+    size_t dot = output.find_last_of('.');
+    size_t slash = output.find_last_of('/');
+    if (dot == string::npos || (slash != string::npos && dot < slash)) {
+        dot = output.size();
+    }
+    return output.substr(0, dot) + ".p" + to_string(partition) + output.substr(dot);
+}
+
+void printConsoleHeader(const string& output) {
+    cout << "Generating market data for multiple symbols and queuing for writing to "
+              << output << ". Press Ctrl+C to stop." << endl;
+    cout << "---------------------------------------------------------" << endl;
+    // Console header for immediate feedback
+    cout << left << setw(25) << "Timestamp"
+              << left << setw(10) << "Symbol"
+              << left << setw(15) << "Price"
+              << left << "Volume" << endl;
+    cout << "---------------------------------------------------------" << endl;
+}
+
+void printTickRow(const MarketDataTick& tick) {
+    // Built first and written once, so rows from concurrent producers never interleave
+    ostringstream row;
+    row << fixed << setprecision(2)
+              << left << setw(25) << tick.getFormattedTimestamp()
+              << left << setw(10) << tick.symbol
+              << left << setw(15) << tick.price
+              << left << tick.volume << '\n';
+    cout << row.str() << flush;
+}
+
+void queueMonitorThread(const QueueTelemetry& telemetry, const atomic<bool>& running,
+                        chrono::milliseconds interval) {
+    MDS_TRACE_THREAD_NAME("queue_monitor");
+    const chrono::milliseconds slice(20); // Short sleeps so shutdown never waits a full interval
+    while (running.load(memory_order_relaxed)) {
+        for (chrono::milliseconds waited(0); waited < interval && running.load(memory_order_relaxed); waited += slice) {
+            this_thread::sleep_for(slice);
+        }
+        QueueTelemetrySnapshot snapshot = telemetry.snapshot();
+        MDS_TRACE_COUNTER("monitor_queue_depth", snapshot.depth);
+        ostringstream line;
+        line << "[Queue Monitor] ";
+        printQueueTelemetry(line, snapshot);
+        cout << line.str() << endl;
+    }
+}
+
+const PipelineEntry* findPipeline(const string& name) {
+    for (const PipelineEntry& entry : pipelineRegistry()) {
+        if (name == entry.name) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+void listPipelines(ostream& out) {
+    for (const PipelineEntry& entry : pipelineRegistry()) {
+        out << "  " << left << setw(16) << entry.name << entry.description << "\n";
+    }
+}
@@ -0,0 +1,670 @@
+#ifndef MARKET_DATA_PIPELINE_H
+#define MARKET_DATA_PIPELINE_H
+
+#include <algorithm>  // For std::max
+#include <atomic>     // For std::atomic
+#include <chrono>     // For std::chrono
+#include <cstdint>    // For uint64_t
+#include <functional> // For std::hash, std::greater
+#include <iostream>   // For std::cout, std::cerr
+#include <memory>     // For std::unique_ptr
+#include <ostream>    // For std::ostream
+#include <queue>      // For std::priority_queue
+#include <random>     // For std::random_device
+#include <stdexcept>  // For std::runtime_error
+#include <string>     // For std::string
+#include <thread>     // For std::thread
+#include <type_traits> // For std::void_t
+#include <utility>    // For std::pair
+#include <vector>     // For std::vector
+#include "marketData.h" // For BasicMarketDataGenerator
+#include "perfCounters.h" // For per-stage hardware counters
+#include "queueTelemetry.h" // For QueueTelemetry
+#include "symbolDemand.h" // For SymbolDemand
+#include "threadSafeQueue.h" // For QueueStopped, thrown by the queues' blocking pops
+#include "throughputController.h" // For PipelineTuning and the adaptive controller
+#include "tickValidator.h" // For --validate
+#include "trace.h"    // For MDS_TRACE_* hot-path trace points
+
+// --- Runtime Options Shared by All Pipeline Configurations ---
+struct PipelineOptions {
+    std::string pipeline = "csv";  // Registry name of the compiled configuration to run
+    std::string output = "multi_symbol_threaded_market_data_output2.csv";
+    int steps = 50;                // More steps to see data accumulate
+    int delayMs = 100;             // Shorter delay
+    bool echo = true;              // Print every tick to the console
+    double targetP99Us = 0.0;      // > 0 enables the adaptive throughput controller
+    uint64_t seed = 0;             // 0 = seed generators from std::random_device
+    size_t symbols = 0;            // 0 = the five default instruments, else a synthetic universe of this size
+    size_t partitions = 1;         // > 1: independent symbol-hash lanes (generator shard, queue, writer, sink)
+    bool merge = false;            // With partitions: k-way timestamp merge into the single output
+    size_t shard = 0;              // With shards > 1: simulate only the symbols of this hash shard
+    size_t shards = 1;             // Symbol-hash shards across processes (see coordinator.h)
+    bool simulatedClock = false;   // Timestamp ticks kSimulatedClockStart + step * max(delayMs, 1) ms
+    bool validate = false;         // Check every written tick's invariants (see tickValidator.h)
+    double tickSize = 0.0;         // With validate: > 0 also checks prices lie on this grid
+    std::function<bool(int)> onStep; // Called with the completed step count; false ends the run early
+    uint64_t* ticksWritten = nullptr; // If set, receives the number of ticks the writers wrote
+};
+
+// Simulated time of step 0 with --sim-clock: 2024-01-02 14:30:00 UTC.
+constexpr std::chrono::system_clock::time_point kSimulatedClockStart{std::chrono::seconds(1704205800)};
+
+struct SymbolSpec {
+    std::string symbol;
+    double initialPrice;
+    long initialVolume;
+};
+
+// The instruments simulated by every pipeline.
+std::vector<SymbolSpec> defaultUniverse();
+
+// Synthetic names are "S" plus seven digits, which fills the 8-byte binary record symbol.
+constexpr size_t kMaxUniverseSymbols = 10000000;
+
+// The default instruments followed by synthetic ones ("S0000005", ...) up to count; 0 = defaultUniverse().
+// Throws std::out_of_range above kMaxUniverseSymbols.
+std::vector<SymbolSpec> makeUniverse(size_t count);
+
+// Seed of partition p's producer-wide RngStream; never equal to a generator's engine seeds.
+inline uint64_t producerStreamSeed(uint64_t seed, size_t partition) { return mixSeed(mixSeed(seed, partition), 2); }
+
+// Hash partition of a symbol, shared by in-process partitions and cross-process shards.
+size_t partitionOf(const std::string& symbol, size_t partitionCount);
+
+// "out.csv" -> "out.p3.csv": the sink path of one partition when partitions are not merged.
+std::string partitionOutput(const std::string& output, size_t partition);
+
+// Console helpers for real-time observation.
+void printConsoleHeader(const std::string& output);
+void printTickRow(const MarketDataTick& tick);
+
+// Samples queue telemetry without taking the queue lock.
+void queueMonitorThread(const QueueTelemetry& telemetry, const std::atomic<bool>& running,
+                        std::chrono::milliseconds interval);
+
+// --- Producer-Side Encoding ---
+// Default for formatters without a Packer: one queue item per generated tick.
+template <typename Formatter>
+class DirectPacker {
+public:
+    explicit DirectPacker(const std::vector<std::string>&) {}
+
+    template <typename Queue>
+    void add(MarketDataTick&& tick, Queue& queue) { queue.push(Formatter::encode(std::move(tick))); }
+
+    template <typename Queue>
+    void flush(Queue&) {}
+};
+
+// Formatter::Packer if the formatter batches ticks itself (e.g. TickBatchCsvFormatter), else DirectPacker.
+template <typename Formatter, typename = void>
+struct PackerOf {
+    using type = DirectPacker<Formatter>;
+};
+
+template <typename Formatter>
+struct PackerOf<Formatter, std::void_t<typename Formatter::Packer>> {
+    using type = typename Formatter::Packer;
+};
+
+// Formatters whose items carry several ticks (e.g. TickBatchCsvFormatter) declare
+// tickCount(item); every other item is one tick.
+template <typename Formatter, typename = void>
+struct CountsTicks : std::false_type {};
+
+template <typename Formatter>
+struct CountsTicks<Formatter,
+                   std::void_t<decltype(Formatter::tickCount(std::declval<const typename Formatter::Item&>()))>>
+    : std::true_type {};
+
+// Sinks with trackDemand(SymbolDemand&) (the subscriber servers) report which symbols are wanted.
+template <typename Sink, typename = void>
+struct TracksDemand : std::false_type {};
+
+template <typename Sink>
+struct TracksDemand<Sink, std::void_t<decltype(std::declval<Sink&>().trackDemand(std::declval<SymbolDemand&>()))>>
+    : std::true_type {};
+
+// --- Compile-Time Specialized Pipeline ---
+// Every stage is a template parameter, so one instantiation is a fully inlined
+// generate -> queue -> format -> sink path with no indirect calls:
+//   Rng, Model - BasicMarketDataGenerator engine and price dynamics
+//   Queue      - queue template instantiated with Formatter::Item (e.g. ThreadSafeQueue); its
+//                blocking pops throw QueueStopped once stopped and drained
+//   Formatter  - see formatters.h; Formatter::Packer, if present, builds queue items from ticks
+//   Sink       - sink template instantiated with Formatter (see sinks.h)
+template <typename Rng, typename Model, template <typename> class Queue, typename Formatter,
+          template <typename> class Sink>
+class Pipeline {
+public:
+    using Generator = BasicMarketDataGenerator<Rng, Model>;
+    using Item = typename Formatter::Item;
+    using QueueType = Queue<Item>;
+    using SinkType = Sink<Formatter>;
+    using Packer = typename PackerOf<Formatter>::type;
+
+    // One independent generator shard -> queue -> writer lane. Symbols are assigned by hash, so
+    // per-symbol order holds within a partition and partitions never synchronize.
+    struct Partition {
+        std::vector<Generator> generators;
+        std::vector<std::string> symbols;
+        std::vector<uint32_t> demandIds;   // Universe position of each generator's symbol
+        std::vector<uint64_t> idleSteps;   // Steps each generator skipped since its last tick
+        uint64_t skippedTicks = 0;
+        uint64_t streamSeed = 0;           // For the producer's RngStream<Rng>
+        std::unique_ptr<Packer> packer;  // Outlives the writer: batches may reference its symbol table
+        QueueType queue;
+        Formatter formatter;             // Per writer: formatters may keep scratch state
+        std::unique_ptr<SinkType> sink;  // Unset when partitions are merged into one sink
+        std::string output;
+        PipelineTuning tuning;
+        WriterLatency writerLatency;
+        std::unique_ptr<TickValidator> validator; // Set with --validate, for this partition's writer
+        std::atomic<bool> writeFailed{false};     // Set by this partition's writer when its sink failed
+        uint64_t ticksWritten = 0;                // By this partition's writer; read once it is joined
+    };
+
+    static int run(const PipelineOptions& options) {
+        MDS_TRACE_THREAD_NAME("generator");
+        size_t partitionCount = std::max<size_t>(options.partitions, 1);
+        bool partitioned = partitionCount > 1;
+
+        // --- Setup Multiple MarketDataGenerators, Sharded by Symbol Hash ---
+        std::vector<SymbolSpec> universe = makeUniverse(options.symbols);
+        std::vector<std::string> universeSymbols;
+        for (const SymbolSpec& spec : universe) {
+            universeSymbols.push_back(spec.symbol);
+        }
+        SymbolDemand demand(universeSymbols); // Outlives the sinks that update it
+        std::vector<std::unique_ptr<Partition>> partitions;
+        for (size_t p = 0; p < partitionCount; ++p) {
+            partitions.push_back(std::make_unique<Partition>());
+            partitions.back()->streamSeed = options.seed != 0 ? producerStreamSeed(options.seed, p) : std::random_device()();
+        }
+        for (size_t i = 0; i < universe.size(); ++i) {
+            const SymbolSpec& spec = universe[i];
+            if (options.shards > 1 && partitionOf(spec.symbol, options.shards) != options.shard) {
+                continue; // Owned by another process
+            }
+            Partition& partition = *partitions[partitionOf(spec.symbol, partitionCount)];
+            partition.symbols.push_back(spec.symbol);
+            partition.demandIds.push_back(static_cast<uint32_t>(i));
+            partition.idleSteps.push_back(0);
+            if (options.seed != 0) {
+                // Seeded by universe position, so paths do not depend on the partition count
+                partition.generators.emplace_back(spec.symbol, spec.initialPrice, spec.initialVolume,
+                                                  mixSeed(options.seed, i));
+            } else {
+                partition.generators.emplace_back(spec.symbol, spec.initialPrice, spec.initialVolume);
+            }
+            if (options.simulatedClock) {
+                partition.generators.back().useSimulatedClock(
+                    kSimulatedClockStart, std::chrono::milliseconds(std::max(options.delayMs, 1)));
+            }
+        }
+
+        // --- Setup Queues, Sinks and Writer Threads ---
+        std::unique_ptr<SinkType> mergedSink;
+        Formatter mergedFormatter;
+        if (!partitioned || options.merge) {
+            mergedSink = std::make_unique<SinkType>(options.output, mergedFormatter);
+            if (!mergedSink->isOpen()) {
+                std::cerr << "Error: could not open file " << options.output << " for writing." << std::endl;
+                return 1;
+            }
+            trackDemand(*mergedSink, demand);
+        }
+        for (size_t p = 0; p < partitionCount; ++p) {
+            Partition& partition = *partitions[p];
+            partition.packer = std::make_unique<Packer>(partition.symbols);
+            if (partitioned && !options.merge) {
+                partition.output = partitionOutput(options.output, p);
+                partition.sink = std::make_unique<SinkType>(partition.output, partition.formatter);
+                if (!partition.sink->isOpen()) {
+                    std::cerr << "Error: could not open file " << partition.output << " for writing." << std::endl;
+                    return 1;
+                }
+                trackDemand(*partition.sink, demand);
+            }
+        }
+
+        // Validators sit between each writer's queue and its sink: one per writer thread
+        std::unique_ptr<TickValidator> mergedValidator;
+        if (options.validate) {
+            if constexpr (IsValidatable<Item>::value) {
+                for (auto& partition : partitions) {
+                    partition->validator = std::make_unique<TickValidator>(options.tickSize);
+                }
+                mergedValidator = std::make_unique<TickValidator>(options.tickSize);
+            } else {
+                std::cout << "[Validate] Not supported for this pipeline's queue items; ignored." << std::endl;
+            }
+        }
+
+        // Each writer has its own failure flag, so one failed sink does not stop the others from
+        // flushing; any failure makes the run exit 1.
+        std::vector<std::thread> writers;
+        std::atomic<bool> mergeFailed{false};
+        uint64_t mergedTicks = 0;
+        if (!partitioned) {
+            Partition& partition = *partitions[0];
+            writers.emplace_back(&Pipeline::writerThread, std::ref(partition.queue), std::ref(*mergedSink),
+                                 std::ref(mergedFormatter), std::cref(partition.tuning),
+                                 std::ref(partition.writerLatency), partition.validator.get(),
+                                 std::ref(partition.writeFailed), std::ref(partition.ticksWritten),
+                                 std::cref(options.output));
+        } else if (options.merge) {
+            writers.emplace_back(&Pipeline::mergeWriterThread, std::ref(partitions), std::ref(*mergedSink),
+                                 std::ref(mergedFormatter), mergedValidator.get(), std::ref(mergeFailed),
+                                 std::ref(mergedTicks), std::cref(options.output));
+        } else {
+            for (auto& partition : partitions) {
+                writers.emplace_back(&Pipeline::writerThread, std::ref(partition->queue), std::ref(*partition->sink),
+                                     std::ref(partition->formatter), std::cref(partition->tuning),
+                                     std::ref(partition->writerLatency), partition->validator.get(),
+                                     std::ref(partition->writeFailed), std::ref(partition->ticksWritten),
+                                     std::cref(partition->output));
+            }
+        }
+
+        // Monitor thread reporting queue depth / stalls once a second (single lane only; partitioned
+        // runs print per-partition telemetry at the end instead of N interleaved monitor lines)
+        std::atomic<bool> monitorRunning{!partitioned};
+        std::thread monitor;
+        if (monitorRunning) {
+            monitor = std::thread(queueMonitorThread, std::cref(partitions[0]->queue.telemetry()),
+                                  std::cref(monitorRunning), std::chrono::milliseconds(1000));
+        }
+
+        // Optional controller thread re-tuning the writer against the latency target
+        std::atomic<bool> controllerRunning{options.targetP99Us > 0.0 && !partitioned && !options.simulatedClock};
+        if (options.targetP99Us > 0.0 && partitioned) {
+            std::cout << "[Partitions] --target-p99-us applies to single-lane runs only; ignored." << std::endl;
+        }
+        if (options.targetP99Us > 0.0 && options.simulatedClock) {
+            // Latency is tick timestamp -> flush, meaningless for simulated timestamps
+            std::cout << "[Controller] Needs wall-clock timestamps; ignored with the simulated clock." << std::endl;
+        }
+        ThroughputController controller(partitions[0]->tuning, partitions[0]->queue.telemetry(),
+                                        partitions[0]->writerLatency, options.targetP99Us);
+        std::thread controllerThread;
+        if (controllerRunning) {
+            controllerThread = std::thread([&] {
+                MDS_TRACE_THREAD_NAME("controller");
+                controller.run(controllerRunning, std::chrono::milliseconds(200));
+            });
+        }
+
+        printConsoleHeader(options.output);
+        if (demand.tracked()) {
+            std::cout << "[Demand] Generating ticks only for subscribed symbols" << std::endl;
+        }
+        if (partitioned) {
+            std::cout << "[Partitions] " << partitionCount << " symbol-hash partitions, "
+                      << (options.merge ? "timestamp-merged into " + options.output
+                                        : "one output per partition (" + partitionOutput(options.output, 0) + ", ...)")
+                      << std::endl;
+        }
+
+        // --- Main Simulation Loop (Producers) ---
+        if (!partitioned) {
+            producerLoop(*partitions[0], demand, options, "generator");
+        } else {
+            std::vector<std::thread> producers;
+            for (size_t p = 0; p < partitionCount; ++p) {
+                producers.emplace_back([&, p] {
+                    MDS_TRACE_THREAD_NAME("generator");
+                    producerLoop(*partitions[p], demand, options, "generator/p" + std::to_string(p));
+                });
+            }
+            for (std::thread& producer : producers) {
+                producer.join();
+            }
+        }
+
+        // --- Shutdown Process ---
+        std::cout << "\n---------------------------------------------------------" << std::endl;
+        std::cout << "Simulation finished. Signaling writer thread to stop..." << std::endl;
+
+        for (auto& partition : partitions) {
+            partition->queue.stop(); // Signal the writer thread(s) to stop processing new items
+        }
+        for (std::thread& writer : writers) {
+            writer.join(); // Wait for the writer threads to finish their work and terminate
+        }
+
+        monitorRunning = false;
+        if (monitor.joinable()) {
+            monitor.join();
+        }
+        if (controllerThread.joinable()) {
+            controllerRunning = false;
+            controllerThread.join();
+        }
+
+        for (size_t p = 0; p < partitionCount; ++p) {
+            std::cout << (partitioned ? "Partition " + std::to_string(p) + " queue telemetry: "
+                                      : std::string("Queue telemetry: "));
+            printQueueTelemetry(std::cout, partitions[p]->queue.telemetry().snapshot());
+            std::cout << std::endl;
+        }
+        if (demand.tracked()) {
+            uint64_t skipped = 0;
+            for (const auto& partition : partitions) {
+                skipped += partition->skippedTicks;
+            }
+            std::cout << "[Demand] " << skipped << " ticks of unsubscribed symbols skipped" << std::endl;
+        }
+
+        // --- Validation Report ---
+        uint64_t violations = 0;
+        if (partitioned && options.merge) {
+            if (mergedValidator) {
+                mergedValidator->print(std::cout, options.output);
+                violations += mergedValidator->counts().violations();
+            }
+        } else {
+            for (auto& partition : partitions) {
+                if (partition->validator) {
+                    partition->validator->print(std::cout, partitioned ? partition->output : options.output);
+                    violations += partition->validator->counts().violations();
+                }
+            }
+        }
+
+        bool writeFailed = mergeFailed;
+        uint64_t ticksWritten = mergedTicks;
+        for (const auto& partition : partitions) {
+            writeFailed = writeFailed || partition->writeFailed;
+            ticksWritten += partition->ticksWritten;
+        }
+        if (options.ticksWritten != nullptr) {
+            *options.ticksWritten = ticksWritten;
+        }
+        if (writeFailed) {
+            std::cerr << "Error: output is incomplete; see the writer errors above." << std::endl;
+        }
+
+        MDS_TRACE_DUMP("market_data_trace.json");
+        perf::printReport(std::cout);
+        return violations == 0 && !writeFailed ? 0 : 1; // A soak run with violations fails
+    }
+
+    template <typename S>
+    static void trackDemand(S& sink, SymbolDemand& demand) {
+        if constexpr (TracksDemand<S>::value) {
+            demand.track();
+            sink.trackDemand(demand);
+        }
+    }
+
+    // --- Producer ---
+    // Steps one partition's generators; the packer turns ticks into queue items. Symbols nobody
+    // wants are not generated; their generators catch up on the missed steps once wanted again.
+    static void producerLoop(Partition& partition, const SymbolDemand& demand, const PipelineOptions& options,
+                             const std::string& stage) {
+        const std::chrono::milliseconds timeStepDelay(options.delayMs);
+        RngStream<Rng> stream(partition.streamSeed);
+
+        perf::PerfCounterGroup generatorCounters;
+        generatorCounters.start();
+
+        int step = 0;
+        while (step < options.steps) {
+            MDS_TRACE_BEGIN("generate_step");
+            for (size_t g = 0; g < partition.generators.size(); ++g) {
+                if (!demand.wanted(partition.demandIds[g])) {
+                    ++partition.idleSteps[g];
+                    ++partition.skippedTicks;
+                    continue;
+                }
+                MDS_TRACE_SCOPE("generate_tick");
+                Generator& generator = partition.generators[g];
+                if (partition.idleSteps[g] != 0) {
+                    generator.advance(partition.idleSteps[g]);
+                    partition.idleSteps[g] = 0;
+                }
+                MarketDataTick tick = generator.generateTick();
+
+                // Print to console (for real-time observation)
+                if (options.echo) {
+                    printTickRow(tick);
+                }
+
+                // Push the tick (or a full batch of ticks) to the queue for the writer thread
+                partition.packer->add(std::move(tick), partition.queue);
+            }
+            partition.packer->flush(partition.queue); // Partial batches never wait past the end of a step
+            MDS_TRACE_END("generate_step");
+            ++step;
+            if (options.onStep && !options.onStep(step)) {
+                break; // Stopped from outside (e.g. by the coordinator at a step barrier)
+            }
+            if (timeStepDelay.count() > 0) {
+                std::this_thread::sleep_for(timeStepDelay);
+            }
+        }
+
+        generatorCounters.stop();
+        perf::recordStage(stage, generatorCounters,
+                          static_cast<uint64_t>(step) * partition.generators.size() - partition.skippedTicks);
+    }
+
+    // --- Writer Thread ---
+    // Pops items in batches and flushes according to the (possibly controller-adjusted) tuning.
+    // With a validator, every batch is checked before it reaches the sink. A sink error (thrown
+    // by writeBatch, flush or close) ends the writer and sets failed.
+    static void writerThread(QueueType& queue, SinkType& sink, Formatter& formatter, const PipelineTuning& tuning,
+                             WriterLatency& latency, TickValidator* validator, std::atomic<bool>& failed,
+                             uint64_t& ticksWritten, const std::string& output) {
+        MDS_TRACE_THREAD_NAME("writer");
+
+        perf::PerfCounterGroup writerCounters;
+        writerCounters.start();
+
+        std::vector<Item> batch;
+        std::vector<std::chrono::system_clock::time_point> unflushed; // Timestamps written since the last flush
+        auto lastFlush = std::chrono::steady_clock::now();
+
+        // Flush the sink and record tick -> flushed latency for everything written since the last flush.
+        auto flushOutput = [&]() {
+            MDS_TRACE_SCOPE("flush");
+            sink.flush();
+            auto flushedAt = std::chrono::system_clock::now();
+            for (const auto& timestamp : unflushed) {
+                latency.record(static_cast<uint64_t>(std::max<int64_t>(
+                    0, std::chrono::duration_cast<std::chrono::nanoseconds>(flushedAt - timestamp).count())));
+            }
+            unflushed.clear();
+            lastFlush = std::chrono::steady_clock::now();
+        };
+
+        try {
+            while (true) {
+                size_t maxBatch = tuning.batchSize.load(std::memory_order_relaxed);
+                uint32_t spins = tuning.spinIterations.load(std::memory_order_relaxed);
+
+                batch.clear();
+                // Spin briefly before parking; a parked writer costs a futex wake per batch.
+                for (uint32_t i = 0; i < spins && batch.empty(); ++i) {
+                    if (queue.try_pop_batch(batch, maxBatch) == 0) {
+                        cpuRelax();
+                    }
+                }
+                if (batch.empty()) {
+                    // About to park: publish what is written first, so a pause in the stream
+                    // does not hold data back past the flush interval
+                    if (!unflushed.empty()) {
+                        flushOutput();
+                    }
+                    queue.wait_and_pop_batch(batch, maxBatch); // Blocks until an item is available or stop is requested
+                }
+
+                MDS_TRACE_SCOPE("write_batch");
+                for (const Item& item : batch) {
+                    unflushed.push_back(Formatter::timestampOf(item));
+                }
+                uint64_t ticks = tickCount(batch); // Before writeBatch, which may take the batch's buffer
+                validateBatch(validator, batch);
+                sink.writeBatch(batch, formatter);
+                ticksWritten += ticks;
+                latency.addTicks(ticks);
+
+                std::chrono::microseconds flushInterval(tuning.flushIntervalUs.load(std::memory_order_relaxed));
+                if (std::chrono::steady_clock::now() - lastFlush >= flushInterval) {
+                    flushOutput(); // Flush on the tuned cadence. Good for debugging/recovery.
+                }
+            }
+        } catch (const QueueStopped& e) {
+            // Expected exception when stop is requested and queue is empty
+            std::cout << "[Writer] Thread stopped: " << e.what() << std::endl;
+        } catch (const std::exception& e) {
+            std::cerr << "[Writer] An unexpected error occurred: " << e.what() << std::endl;
+            failed = true;
+        }
+        finishSink(sink, failed, output, "[Writer]", [&] { flushOutput(); });
+
+        writerCounters.stop();
+        perf::recordStage("writer", writerCounters, ticksWritten);
+    }
+
+    // Final flush and close, which may report errors of their own (e.g. buffered writes). After a
+    // failure the sink is only closed, and its repeated error is not printed again.
+    template <typename Flush>
+    static void finishSink(SinkType& sink, std::atomic<bool>& failed, const std::string& output, const char* tag,
+                           Flush&& flush) {
+        try {
+            if (!failed) {
+                flush();
+            }
+            sink.close();
+            std::cout << tag << " File " << output << " closed." << std::endl;
+        } catch (const std::exception& e) {
+            if (!failed) {
+                std::cerr << tag << " Could not finish " << output << ": " << e.what() << std::endl;
+            }
+            failed = true;
+        }
+    }
+
+    static uint64_t tickCount(const std::vector<Item>& batch) {
+        if constexpr (CountsTicks<Formatter>::value) {
+            uint64_t ticks = 0;
+            for (const Item& item : batch) {
+                ticks += Formatter::tickCount(item);
+            }
+            return ticks;
+        } else {
+            return batch.size();
+        }
+    }
+
+    static void validateBatch(TickValidator* validator, const std::vector<Item>& batch) {
+        if constexpr (IsValidatable<Item>::value) {
+            if (validator) {
+                MDS_TRACE_SCOPE("validate_batch");
+                validator->check(batch);
+            }
+        }
+    }
+
+    // --- Ordered Merge Writer ---
+    // The only cross-partition stage: a k-way merge by Formatter::timestampOf over the partition
+    // queues into one sink. An item is written only once every live partition has a later (or
+    // equal) head, so the merged stream is ordered (per item; batch items order by their first tick).
+    static void mergeWriterThread(std::vector<std::unique_ptr<Partition>>& partitions, SinkType& sink,
+                                  Formatter& formatter, TickValidator* validator, std::atomic<bool>& failed,
+                                  uint64_t& ticksWritten, const std::string& output) {
+        MDS_TRACE_THREAD_NAME("merge_writer");
+        constexpr size_t kPopBatch = 1024;
+
+        struct Source {
+            std::vector<Item> pending;
+            size_t next = 0;
+            bool finished = false;
+        };
+        using Head = std::pair<std::chrono::system_clock::time_point, size_t>; // (timestamp, partition)
+
+        std::vector<Source> sources(partitions.size());
+        std::vector<Item> merged;
+        std::priority_queue<Head, std::vector<Head>, std::greater<Head>> heads;
+
+        auto writeMerged = [&]() {
+            if (!merged.empty()) {
+                MDS_TRACE_SCOPE("write_batch");
+                uint64_t ticks = tickCount(merged);
+                validateBatch(validator, merged);
+                sink.writeBatch(merged, formatter);
+                ticksWritten += ticks;
+                merged.clear();
+            }
+        };
+
+        // Makes sure source p has an unread item; false once its queue is stopped and drained.
+        auto refill = [&](size_t p) {
+            Source& source = sources[p];
+            while (source.next == source.pending.size()) {
+                if (source.finished) {
+                    return false;
+                }
+                source.pending.clear();
+                source.next = 0;
+                if (partitions[p]->queue.try_pop_batch(source.pending, kPopBatch) > 0) {
+                    break;
+                }
+                // About to wait on this partition: publish what is already ordered first
+                writeMerged();
+                sink.flush();
+                try {
+                    partitions[p]->queue.wait_and_pop_batch(source.pending, kPopBatch);
+                } catch (const QueueStopped&) {
+                    source.finished = true; // Stop was requested and the queue is empty
+                }
+            }
+            return true;
+        };
+
+        try {
+            // Priming may already flush the sink (refill publishes before it waits)
+            for (size_t p = 0; p < sources.size(); ++p) {
+                if (refill(p)) {
+                    heads.push({Formatter::timestampOf(sources[p].pending[sources[p].next]), p});
+                }
+            }
+            while (!heads.empty()) {
+                size_t p = heads.top().second;
+                heads.pop();
+                merged.push_back(std::move(sources[p].pending[sources[p].next++]));
+                if (merged.size() >= kPopBatch) {
+                    writeMerged();
+                }
+                if (refill(p)) {
+                    heads.push({Formatter::timestampOf(sources[p].pending[sources[p].next]), p});
+                }
+            }
+            writeMerged();
+            std::cout << "[Merge Writer] All " << sources.size() << " partitions drained." << std::endl;
+        } catch (const std::exception& e) {
+            std::cerr << "[Merge Writer] An unexpected error occurred: " << e.what() << std::endl;
+            failed = true;
+        }
+        std::cout << "[Merge Writer] " << ticksWritten << " ticks merged." << std::endl;
+        finishSink(sink, failed, output, "[Merge Writer]", [&] { sink.flush(); });
+    }
+};
+
+// --- Registry of Pre-Instantiated Configurations ---
+// Selecting a configuration at runtime is a single indirect call to run(); everything
+// below it is specialized code.
+struct PipelineEntry {
+    const char* name;
+    const char* description;
+    int (*run)(const PipelineOptions&);
+};
+
+const std::vector<PipelineEntry>& pipelineRegistry();
+const PipelineEntry* findPipeline(const std::string& name);
+void listPipelines(std::ostream& out);
+
+#endif // MARKET_DATA_PIPELINE_H
@@ -0,0 +1,63 @@
+// Explicit instantiations of the common pipeline configurations. Each entry compiles into its
+// own specialized hot loop; add a line here to make a new combination selectable by --pipeline.
+#include "pipeline.h"
+#include "binaryRecord.h"    // For BinaryRecordFormatter
+#include "feedServer.h"      // For FeedSink
+#include "formatters.h"      // For CsvFormatter, FastCsvFormatter, JsonFormatter
+#include "marketEvent.h"     // For MarketEventCsvFormatter, MarketEventRecordFormatter
+#include "mmapSink.h"        // For MmapSink
+#include "philox.h"          // For Philox4x32
+#include "randomPrefill.h"   // For PrefilledEngine
+#include "sinks.h"           // For FileSink, NullSink
+#include "splitFileSink.h"   // For SplitFileSink
+#include "threadSafeQueue.h" // For ThreadSafeQueue
+#include "tickBatch.h"       // For TickBatchCsvFormatter
+#include "vectoredFileSink.h" // For VectoredFileSink
+#include "webSocketServer.h" // For WebSocketSink
+#include <random>            // For mt19937, mt19937_64, minstd_rand
+
+using namespace std;
+
+const vector<PipelineEntry>& pipelineRegistry() {
+    static const vector<PipelineEntry> entries = {
+        {"csv", "mt19937 random walk -> ThreadSafeQueue -> CSV file (default)",
+         &Pipeline<mt19937, RandomWalkModel, ThreadSafeQueue, CsvFormatter, FileSink>::run},
+        {"csv-fast", "mt19937 random walk -> ThreadSafeQueue -> CSV file via lookup-table formatting",
+         &Pipeline<mt19937, RandomWalkModel, ThreadSafeQueue, FastCsvFormatter, FileSink>::run},
+        {"csv-minstd", "minstd_rand random walk (small RNG state) -> ThreadSafeQueue -> CSV file",
+         &Pipeline<minstd_rand, RandomWalkModel, ThreadSafeQueue, CsvFormatter, FileSink>::run},
+        {"csv-gbm", "mt19937_64 geometric Brownian motion (buffered ziggurat normals) -> ThreadSafeQueue -> CSV file",
+         &Pipeline<mt19937_64, GbmModel, ThreadSafeQueue, FastCsvFormatter, FileSink>::run},
+        {"csv-prefill", "random walk on mt19937_64 words prefilled by a per-producer thread (pays off when paced) -> CSV file",
+         &Pipeline<PrefilledEngine<mt19937_64>, RandomWalkModel, ThreadSafeQueue, FastCsvFormatter, FileSink>::run},
+        {"csv-philox", "Philox4x32-10 counter-based random walk (draws a pure function of seed, symbol, step) -> CSV file",
+         &Pipeline<Philox4x32, RandomWalkModel, ThreadSafeQueue, FastCsvFormatter, FileSink>::run},
+        {"binary", "mt19937 random walk -> ThreadSafeQueue<TickRecord> -> 32-byte records via pwritev2/writev",
+         &Pipeline<mt19937, RandomWalkModel, ThreadSafeQueue, BinaryRecordFormatter, VectoredFileSink>::run},
+        {"binary-stream", "mt19937 random walk -> ThreadSafeQueue<TickRecord> -> 32-byte records via ofstream",
+         &Pipeline<mt19937, RandomWalkModel, ThreadSafeQueue, BinaryRecordFormatter, FileSink>::run},
+        {"binary-mmap", "mt19937 random walk -> ThreadSafeQueue<TickRecord> -> 32-byte records into an mmap'd file",
+         &Pipeline<mt19937, RandomWalkModel, ThreadSafeQueue, BinaryRecordFormatter, MmapSink>::run},
+        {"csv-mmap", "mt19937 random walk -> ThreadSafeQueue -> lookup-table CSV into an mmap'd file",
+         &Pipeline<mt19937, RandomWalkModel, ThreadSafeQueue, FastCsvFormatter, MmapSink>::run},
+        {"csv-split", "mt19937 random walk -> ThreadSafeQueue -> one lookup-table CSV file per symbol (OUTPUT.SYMBOL.csv)",
+         &Pipeline<mt19937, RandomWalkModel, ThreadSafeQueue, FastCsvFormatter, SplitFileSink>::run},
+        {"csv-columnar", "mt19937 random walk -> ThreadSafeQueue<TickBatch> (structure of arrays) -> CSV file",
+         &Pipeline<mt19937, RandomWalkModel, ThreadSafeQueue, TickBatchCsvFormatter, FileSink>::run},
+        {"events-csv", "mt19937 random walk -> ThreadSafeQueue<MarketEvent> -> typed event CSV rows",
+         &Pipeline<mt19937, RandomWalkModel, ThreadSafeQueue, MarketEventCsvFormatter, FileSink>::run},
+        {"events-binary", "mt19937 random walk -> ThreadSafeQueue<MarketEvent> -> 64-byte events via pwritev2/writev",
+         &Pipeline<mt19937, RandomWalkModel, ThreadSafeQueue, MarketEventRecordFormatter, VectoredFileSink>::run},
+        {"feed", "mt19937 random walk -> ThreadSafeQueue -> lookup-table CSV rows to TCP subscribers (--output HOST:PORT)",
+         &Pipeline<mt19937, RandomWalkModel, ThreadSafeQueue, FastCsvFormatter, FeedSink>::run},
+        {"json", "mt19937 random walk -> ThreadSafeQueue -> newline-delimited JSON file",
+         &Pipeline<mt19937, RandomWalkModel, ThreadSafeQueue, JsonFormatter, FileSink>::run},
+        {"websocket", "mt19937 random walk -> ThreadSafeQueue -> JSON ticks to WebSocket clients (--output HOST:PORT)",
+         &Pipeline<mt19937, RandomWalkModel, ThreadSafeQueue, JsonFormatter, WebSocketSink>::run},
+        {"null", "mt19937 random walk -> ThreadSafeQueue -> CSV formatting, output discarded",
+         &Pipeline<mt19937, RandomWalkModel, ThreadSafeQueue, CsvFormatter, NullSink>::run},
+        {"null-fast", "mt19937 random walk -> ThreadSafeQueue -> lookup-table CSV formatting, output discarded",
+         &Pipeline<mt19937, RandomWalkModel, ThreadSafeQueue, FastCsvFormatter, NullSink>::run},
+    };
+    return entries;
+}
@@ -0,0 +1,173 @@
+#ifndef MARKET_DATA_QUEUE_STRESS_H
+#define MARKET_DATA_QUEUE_STRESS_H
+
+#include <chrono>     // For std::chrono::microseconds
+#include <cstddef>    // For size_t
+#include <cstdint>    // For uint32_t, uint64_t
+#include <random>     // For std::minstd_rand
+#include <stdexcept>  // For std::runtime_error
+#include <thread>     // For std::thread, std::this_thread
+#include <vector>     // For std::vector
+#include "throughputController.h" // For cpuRelax
+
+// --- Queue Stress / Property Check ---
+// Drives a pipeline queue (push, try_pop, wait_and_pop, try_pop_batch, wait_and_pop_batch, stop;
+// see ThreadSafeQueue) with many producers and consumers under randomized timing, and checks the
+// properties the pipeline relies on:
+//   - no loss: every pushed item is popped once stop() has drained the queue
+//   - no duplication: no item is popped twice
+//   - per-producer FIFO: each consumer sees a producer's items in push order
+//   - integrity: items arrive intact (a checksum field guards against torn moves)
+//   - shutdown: every consumer, blocked or not, is released by stop()
+// Intended for any queue that replaces ThreadSafeQueue, and for running under ThreadSanitizer
+// (-DMDS_SANITIZE=thread) to catch the races a property check cannot see.
+struct QueueStressConfig {
+    uint64_t seed = 1;        // Drives each thread's operation mix and timing jitter
+    size_t producers = 4;
+    size_t consumers = 2;
+    uint32_t itemsPerProducer = 20000;
+    size_t maxBatch = 64;     // Batch pops take 1..maxBatch items
+};
+
+struct QueueStressResult {
+    uint64_t pushed = 0;
+    uint64_t popped = 0;
+    uint64_t lost = 0;
+    uint64_t duplicated = 0;
+    uint64_t reordered = 0;   // Popped before an earlier item of the same producer, by one consumer
+    uint64_t corrupted = 0;
+
+    bool ok() const { return popped == pushed && lost == 0 && duplicated == 0 && reordered == 0 && corrupted == 0; }
+};
+
+struct StressItem {
+    uint32_t producer = 0;
+    uint32_t sequence = 0;
+    uint64_t check = 0;       // checkOf(producer, sequence)
+
+    static uint64_t checkOf(uint32_t producer, uint32_t sequence) {
+        uint64_t x = (uint64_t(producer) << 32 | sequence) * 0x9E3779B97F4A7C15ULL;
+        return x ^ (x >> 29);
+    }
+};
+
+template <template <typename> class Queue>
+QueueStressResult runQueueStress(const QueueStressConfig& config) {
+    Queue<StressItem> queue;
+
+    // Jitter before an operation: mostly none, sometimes a spin, a yield or a short sleep, so
+    // threads interleave differently on every run.
+    auto jitter = [](std::minstd_rand& rng) {
+        uint32_t roll = rng() % 1024;
+        if (roll < 900) {
+            return;
+        }
+        if (roll < 1000) {
+            for (uint32_t i = rng() % 256; i > 0; --i) {
+                cpuRelax();
+            }
+        } else if (roll < 1020) {
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(std::chrono::microseconds(rng() % 200));
+        }
+    };
+
+    // --- Consumers ---
+    struct ConsumerLog {
+        std::vector<int64_t> lastSequence; // Per producer, as seen by this consumer
+        std::vector<StressItem> items;
+        uint64_t reordered = 0;
+        uint64_t corrupted = 0;
+    };
+    std::vector<ConsumerLog> logs(config.consumers);
+    std::vector<std::thread> consumers;
+    for (size_t c = 0; c < config.consumers; ++c) {
+        consumers.emplace_back([&, c] {
+            ConsumerLog& log = logs[c];
+            log.lastSequence.assign(config.producers, -1);
+            std::minstd_rand rng(static_cast<uint32_t>(config.seed * 7919 + 1000 + c));
+            std::vector<StressItem> batch;
+            auto record = [&](const StressItem& item) {
+                if (item.producer >= config.producers || item.sequence >= config.itemsPerProducer ||
+                    item.check != StressItem::checkOf(item.producer, item.sequence)) {
+                    ++log.corrupted;
+                    return;
+                }
+                log.reordered += static_cast<int64_t>(item.sequence) <= log.lastSequence[item.producer];
+                log.lastSequence[item.producer] = item.sequence;
+                log.items.push_back(item);
+            };
+            try {
+                while (true) {
+                    jitter(rng);
+                    batch.clear();
+                    StressItem item;
+                    switch (rng() % 4) {
+                    case 0:
+                        if (queue.try_pop(item)) {
+                            record(item);
+                        }
+                        break;
+                    case 1:
+                        queue.wait_and_pop(item); // Throws once stopped and drained
+                        record(item);
+                        break;
+                    case 2:
+                        queue.try_pop_batch(batch, 1 + rng() % config.maxBatch);
+                        break;
+                    default:
+                        queue.wait_and_pop_batch(batch, 1 + rng() % config.maxBatch);
+                        break;
+                    }
+                    for (const StressItem& popped : batch) {
+                        record(popped);
+                    }
+                }
+            } catch (const std::runtime_error&) {
+                // Stop was requested and the queue is empty
+            }
+        });
+    }
+
+    // --- Producers ---
+    std::vector<std::thread> producers;
+    for (size_t p = 0; p < config.producers; ++p) {
+        producers.emplace_back([&, p] {
+            std::minstd_rand rng(static_cast<uint32_t>(config.seed * 7919 + p + 1));
+            uint32_t producer = static_cast<uint32_t>(p);
+            for (uint32_t s = 0; s < config.itemsPerProducer; ++s) {
+                jitter(rng);
+                queue.push(StressItem{producer, s, StressItem::checkOf(producer, s)});
+            }
+        });
+    }
+    for (std::thread& producer : producers) {
+        producer.join();
+    }
+    queue.stop();
+    for (std::thread& consumer : consumers) {
+        consumer.join();
+    }
+
+    // --- Properties ---
+    QueueStressResult result;
+    result.pushed = uint64_t(config.producers) * config.itemsPerProducer;
+    std::vector<uint8_t> seen(result.pushed, 0);
+    for (const ConsumerLog& log : logs) {
+        result.reordered += log.reordered;
+        result.corrupted += log.corrupted;
+        result.popped += log.items.size() + log.corrupted;
+        for (const StressItem& item : log.items) {
+            uint8_t& count = seen[uint64_t(item.producer) * config.itemsPerProducer + item.sequence];
+            result.duplicated += count != 0;
+            count = 1;
+        }
+    }
+    for (uint8_t count : seen) {
+        result.lost += count == 0;
+    }
+    return result;
+}
+
+#endif // MARKET_DATA_QUEUE_STRESS_H
@@ -0,0 +1,40 @@
+#include "queueTelemetry.h"
+#include <iomanip>    // For fixed, setprecision
+
+using namespace std;
+
+uint64_t histogramPercentileNs(const Log2Histogram& histogram, double quantile) {
+    uint64_t total = 0;
+    for (uint64_t count : histogram) {
+        total += count;
+    }
+    if (total == 0) {
+        return 0;
+    }
+
+    uint64_t target = static_cast<uint64_t>(quantile * static_cast<double>(total));
+    if (target >= total) {
+        target = total - 1;
+    }
+    uint64_t seen = 0;
+    for (int i = 0; i < kLog2HistogramBuckets; ++i) {
+        seen += histogram[i];
+        if (seen > target) {
+            return i == 0 ? 0 : (uint64_t{1} << i) - 1;
+        }
+    }
+    return UINT64_MAX;
+}
+
+void printQueueTelemetry(ostream& out, const QueueTelemetrySnapshot& snapshot) {
+    out << "depth=" << snapshot.depth
+        << " max=" << snapshot.maxDepth
+        << " pushed=" << snapshot.pushes
+        << " popped=" << snapshot.pops
+        << fixed << setprecision(3)
+        << " producerBlocked=" << static_cast<double>(snapshot.producerBlockedNs) / 1e6 << "ms"
+        << " consumerIdle=" << static_cast<double>(snapshot.consumerIdleNs) / 1e6 << "ms"
+        << " residency p50<=" << static_cast<double>(snapshot.residencyPercentileNs(0.50)) / 1e3 << "us"
+        << " p99<=" << static_cast<double>(snapshot.residencyPercentileNs(0.99)) / 1e3 << "us"
+        << " max<=" << static_cast<double>(snapshot.residencyPercentileNs(1.0)) / 1e3 << "us";
+}
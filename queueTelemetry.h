@@ -0,0 +1,126 @@
+#ifndef MARKET_DATA_QUEUE_TELEMETRY_H
+#define MARKET_DATA_QUEUE_TELEMETRY_H
+
+#include <array>      // For std::array
+#include <atomic>     // For std::atomic
+#include <chrono>     // For std::chrono::steady_clock
+#include <cstdint>    // For uint64_t
+#include <ostream>    // For std::ostream
+
+// Bucket i counts samples in [2^(i-1), 2^i) nanoseconds (bucket 0: 0 ns).
+constexpr int kLog2HistogramBuckets = 64;
+using Log2Histogram = std::array<uint64_t, kLog2HistogramBuckets>;
+
+// Upper bound of the bucket containing the given quantile (0..1), in nanoseconds.
+uint64_t histogramPercentileNs(const Log2Histogram& histogram, double quantile);
+
+// Log2 latency histogram with a single writer and lock-free readers.
+class AtomicLog2Histogram {
+public:
+    static int bucketFor(uint64_t ns) {
+        int bucket = ns == 0 ? 0 : 64 - __builtin_clzll(ns);
+        return bucket < kLog2HistogramBuckets ? bucket : kLog2HistogramBuckets - 1;
+    }
+
+    // Callers must serialize record() (one writer thread, or under a lock).
+    void record(uint64_t ns) {
+        std::atomic<uint64_t>& bucket = buckets_[bucketFor(ns)];
+        bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    Log2Histogram snapshot() const {
+        Log2Histogram histogram;
+        for (int i = 0; i < kLog2HistogramBuckets; ++i) {
+            histogram[i] = buckets_[i].load(std::memory_order_relaxed);
+        }
+        return histogram;
+    }
+
+private:
+    std::atomic<uint64_t> buckets_[kLog2HistogramBuckets] = {};
+};
+
+// Point-in-time copy of a queue's counters, safe to inspect at leisure.
+struct QueueTelemetrySnapshot {
+    uint64_t depth = 0;
+    uint64_t maxDepth = 0;
+    uint64_t pushes = 0;
+    uint64_t pops = 0;
+    uint64_t producerBlockedNs = 0; // Time producers spent waiting for the queue lock
+    uint64_t consumerIdleNs = 0;    // Time consumers spent waiting for work (or the lock)
+    Log2Histogram residencyHistogram{}; // How long sampled items sat in the queue (1 in kResidencySampleEvery)
+
+    uint64_t residencyPercentileNs(double quantile) const {
+        return histogramPercentileNs(residencyHistogram, quantile);
+    }
+};
+
+void printQueueTelemetry(std::ostream& out, const QueueTelemetrySnapshot& snapshot);
+
+// Counters updated by the queue while it holds its own lock and read lock-free by monitors.
+// Writers are serialized by the queue mutex, so plain relaxed load/store is enough (no RMW).
+// Residency is sampled: only every kResidencySampleEvery-th pushed item is timestamped, so an
+// uncontended push or pop reads the clock for one item in that many. Lock waits and consumer
+// idle time are timed whenever they happen.
+class QueueTelemetry {
+public:
+    static constexpr uint64_t kResidencySampleEvery = 16;
+
+    static uint64_t nowNs() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    // Whether the item about to be pushed should carry an enqueue timestamp.
+    bool sampleNextPush() const { return pushes_.load(std::memory_order_relaxed) % kResidencySampleEvery == 0; }
+
+    void onPush(uint64_t depthAfter) {
+        bump(pushes_);
+        depth_.store(depthAfter, std::memory_order_relaxed);
+        if (depthAfter > maxDepth_.load(std::memory_order_relaxed)) {
+            maxDepth_.store(depthAfter, std::memory_order_relaxed);
+        }
+    }
+
+    void onPop(uint64_t depthAfter) {
+        bump(pops_);
+        depth_.store(depthAfter, std::memory_order_relaxed);
+    }
+
+    // For a sampled item: enqueue and dequeue times, both from nowNs().
+    void recordResidency(uint64_t enqueuedNs, uint64_t dequeuedNs) {
+        residency_.record(dequeuedNs > enqueuedNs ? dequeuedNs - enqueuedNs : 0);
+    }
+
+    void addProducerBlocked(uint64_t ns) { add(producerBlockedNs_, ns); }
+    void addConsumerIdle(uint64_t ns) { add(consumerIdleNs_, ns); }
+
+    QueueTelemetrySnapshot snapshot() const {
+        QueueTelemetrySnapshot s;
+        s.depth = depth_.load(std::memory_order_relaxed);
+        s.maxDepth = maxDepth_.load(std::memory_order_relaxed);
+        s.pushes = pushes_.load(std::memory_order_relaxed);
+        s.pops = pops_.load(std::memory_order_relaxed);
+        s.producerBlockedNs = producerBlockedNs_.load(std::memory_order_relaxed);
+        s.consumerIdleNs = consumerIdleNs_.load(std::memory_order_relaxed);
+        s.residencyHistogram = residency_.snapshot();
+        return s;
+    }
+
+private:
+    // Only ever called with the queue lock held, so a load/store pair cannot lose updates.
+    static void bump(std::atomic<uint64_t>& counter) { add(counter, 1); }
+    static void add(std::atomic<uint64_t>& counter, uint64_t delta) {
+        counter.store(counter.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+    }
+
+    std::atomic<uint64_t> depth_{0};
+    std::atomic<uint64_t> maxDepth_{0};
+    std::atomic<uint64_t> pushes_{0};
+    std::atomic<uint64_t> pops_{0};
+    std::atomic<uint64_t> producerBlockedNs_{0};
+    std::atomic<uint64_t> consumerIdleNs_{0};
+    AtomicLog2Histogram residency_;
+};
+
+#endif // MARKET_DATA_QUEUE_TELEMETRY_H
@@ -0,0 +1,186 @@
+#ifndef MARKET_DATA_RANDOM_PREFILL_H
+#define MARKET_DATA_RANDOM_PREFILL_H
+
+#include <condition_variable> // For std::condition_variable
+#include <cstddef>    // For size_t
+#include <cstdint>    // For uint64_t
+#include <limits>     // For std::numeric_limits
+#include <memory>     // For std::unique_ptr
+#include <mutex>      // For std::mutex, std::unique_lock
+#include <stdexcept>  // For std::logic_error
+#include <thread>     // For std::thread
+#include "gaussian.h" // For randomBits64
+#include "marketData.h" // For RngJump, RngStream
+#include "trace.h"    // For MDS_TRACE_THREAD_NAME
+
+// --- Background-Refilled Random Buffers ---
+// Two large buffers of 64-bit random words. The consumer reads one while a background thread
+// refills the other from Engine, so the consumer's cost per word is a load and an increment.
+// It only synchronizes when a buffer runs out, once every kBufferWords words. stalls() counts
+// the swaps that had to wait for the refill thread, which happens only when words are consumed
+// faster than Engine can produce them.
+template <typename Engine>
+class RandomPrefill {
+public:
+    static constexpr size_t kBufferWords = 1 << 16; // 512 KB per buffer
+
+    explicit RandomPrefill(uint64_t seed)
+        : engine_(static_cast<typename SeedTypeOf<Engine>::type>(seed)),
+          buffers_{std::make_unique<uint64_t[]>(kBufferWords), std::make_unique<uint64_t[]>(kBufferWords)} {
+        fill(buffers_[0].get());
+        filled_[0] = true;
+        active_ = buffers_[0].get();
+        refillThread_ = std::thread(&RandomPrefill::refillLoop, this);
+    }
+
+    ~RandomPrefill() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        changed_.notify_all();
+        refillThread_.join();
+    }
+
+    RandomPrefill(const RandomPrefill&) = delete;
+    RandomPrefill& operator=(const RandomPrefill&) = delete;
+
+    uint64_t next() {
+        if (position_ == kBufferWords) {
+            swap();
+        }
+        return active_[position_++];
+    }
+
+    uint64_t stalls() const { return stalls_; }
+
+private:
+    void fill(uint64_t* buffer) {
+        for (size_t i = 0; i < kBufferWords; ++i) {
+            buffer[i] = randomBits64(engine_);
+        }
+    }
+
+    // Hands the drained buffer back for refilling and switches to the other one.
+    void swap() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        filled_[current_] = false;
+        current_ ^= 1;
+        if (!filled_[current_]) {
+            ++stalls_;
+            changed_.wait(lock, [&] { return filled_[current_]; });
+        }
+        active_ = buffers_[current_].get();
+        position_ = 0;
+        lock.unlock();
+        changed_.notify_all();
+    }
+
+    void refillLoop() {
+        MDS_TRACE_THREAD_NAME("rng_prefill");
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            changed_.wait(lock, [&] { return stopping_ || !filled_[0] || !filled_[1]; });
+            if (stopping_) {
+                return;
+            }
+            int target = filled_[current_] ? current_ ^ 1 : current_; // The one being waited for first
+            lock.unlock();
+            fill(buffers_[target].get()); // The consumer never reads an unfilled buffer
+            lock.lock();
+            filled_[target] = true;
+            changed_.notify_all();
+        }
+    }
+
+    Engine engine_; // Refill thread only, apart from the first fill
+    std::unique_ptr<uint64_t[]> buffers_[2];
+
+    // --- Consumer Only ---
+    const uint64_t* active_ = nullptr;
+    size_t position_ = 0;
+    uint64_t stalls_ = 0;
+
+    // --- Shared with the refill thread ---
+    std::mutex mutex_;
+    std::condition_variable changed_;
+    bool filled_[2] = {false, false};
+    int current_ = 0;
+    bool stopping_ = false;
+    std::thread refillThread_;
+};
+
+// --- Prefilled Engine ---
+// UniformRandomBitGenerator over the RandomPrefill<Engine> of the RngStream active on the
+// drawing thread. The pipeline's producer owns one per partition, seeded from --seed and the
+// partition index, so every generator a producer steps shares one background-refilled stream:
+// one refill thread per producer, and no RNG state updates in the producer loop. The seed
+// passed to the engine itself is not used. Seeded runs stay reproducible for a given partition
+// count, because producers step their symbols in a fixed order, and every run starts a fresh
+// stream. Per-symbol streams are gone, though, so paths change when the partition count changes.
+template <typename Engine>
+class PrefilledEngine {
+public:
+    using result_type = uint64_t;
+    using seed_type = uint64_t;
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    // The seed is ignored: draws come from the producer's RngStream.
+    explicit PrefilledEngine(uint64_t = 1) {}
+
+    result_type operator()() {
+        if (!pool_) {
+            // Engines are built on one thread and stepped on another
+            pool_ = activePool();
+            if (!pool_) {
+                throw std::logic_error("PrefilledEngine drawn outside an RngStream");
+            }
+        }
+        return pool_->next();
+    }
+
+    void discard(uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) {
+            (*this)();
+        }
+    }
+
+    // The calling thread's RngStream pool, or null.
+    static RandomPrefill<Engine>*& activePool() {
+        thread_local RandomPrefill<Engine>* pool = nullptr;
+        return pool;
+    }
+
+private:
+    RandomPrefill<Engine>* pool_ = nullptr; // Owned by the RngStream, which outlives the draws
+};
+
+// Owns the stream PrefilledEngines draw from on this thread while it is alive.
+template <typename Engine>
+struct RngStream<PrefilledEngine<Engine>> {
+    explicit RngStream(uint64_t seed) : pool_(seed), previous_(PrefilledEngine<Engine>::activePool()) {
+        PrefilledEngine<Engine>::activePool() = &pool_;
+    }
+
+    ~RngStream() { PrefilledEngine<Engine>::activePool() = previous_; }
+
+    RngStream(const RngStream&) = delete;
+    RngStream& operator=(const RngStream&) = delete;
+
+    const RandomPrefill<Engine>& pool() const { return pool_; }
+
+private:
+    RandomPrefill<Engine> pool_;
+    RandomPrefill<Engine>* previous_;
+};
+
+// The stream is shared by all of a producer's generators, so no generator has a position of its
+// own to keep: jumping after a skip would only burn prefilled words.
+template <typename Engine>
+struct RngJump<PrefilledEngine<Engine>> {
+    static void jump(PrefilledEngine<Engine>&, uint64_t) {}
+};
+
+#endif // MARKET_DATA_RANDOM_PREFILL_H
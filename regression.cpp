@@ -0,0 +1,271 @@
+#include "regression.h"
+#include <algorithm>  // For sort, max
+#include <cstdint>    // For uint64_t
+#include <cstdio>     // For snprintf
+#include <cstdlib>    // For setenv
+#include <ctime>      // For tzset
+#include <filesystem> // For directory_iterator, create_directories, remove_all
+#include <fstream>    // For ifstream, ofstream
+#include <iostream>   // For cout, cerr
+#include <map>        // For map
+#include <random>     // For mt19937, mt19937_64, minstd_rand
+#include <sstream>    // For istringstream
+#include <thread>     // For thread
+#include <vector>     // For vector
+#include "marketData.h" // For BasicMarketDataGenerator, GbmModel
+#include "philox.h"   // For Philox4x32
+#include "pipeline.h" // For the registry, makeUniverse, producerStreamSeed, kSimulatedClockStart
+#include "randomPrefill.h" // For PrefilledEngine
+#include "xxhash64.h" // For XxHash64
+
+#include <unistd.h>   // For getpid
+
+using namespace std;
+namespace fs = std::filesystem;
+
+namespace {
+
+// --- The Fixed Configuration ---
+constexpr uint64_t kSeed = 20240102;
+constexpr size_t kSymbols = 20;
+constexpr int kSteps = 100;
+
+// Pipelines with no file output: network servers and the discarding sinks.
+const vector<string> kUnfiled = {"feed", "websocket", "null", "null-fast"};
+
+struct Checksum {
+    uint64_t hash = 0;
+    uint64_t size = 0; // Bytes for outputs, ticks for streams
+};
+
+string hex64(uint64_t value) {
+    char text[17];
+    snprintf(text, sizeof(text), "%016llx", static_cast<unsigned long long>(value));
+    return text;
+}
+
+// Runs body on a fresh thread, with its console output discarded. Pipelines run their producer
+// on the calling thread, and per-thread state (timestamp caches) must start clean for every case.
+template <typename Body>
+void runIsolated(Body&& body) {
+    ostringstream discarded;
+    streambuf* console = cout.rdbuf(discarded.rdbuf());
+    thread runner(std::forward<Body>(body));
+    runner.join();
+    cout.rdbuf(console);
+}
+
+// --- Tick Streams (Fast Mode) ---
+// Every symbol of the universe stepped in pipeline order (step-major), with partition 0's
+// RngStream, as producerLoop does.
+// Every gapEvery-th step each symbol instead advances by a gap, alternating an exact (3) and an
+// aggregated (200) one, to cover advance() and the RNG jumps.
+template <typename Generator>
+Checksum streamChecksum(size_t gapEvery) {
+    Checksum checksum;
+    runIsolated([&] {
+        vector<SymbolSpec> universe = makeUniverse(kSymbols);
+        vector<Generator> generators;
+        for (size_t i = 0; i < universe.size(); ++i) {
+            generators.emplace_back(universe[i].symbol, universe[i].initialPrice, universe[i].initialVolume,
+                                    mixSeed(kSeed, i));
+            generators.back().useSimulatedClock(kSimulatedClockStart, chrono::milliseconds(1));
+        }
+        RngStream<typename Generator::RngType> stream(producerStreamSeed(kSeed, 0));
+        XxHash64 hash(kSeed);
+        for (int step = 0; step < kSteps; ++step) {
+            bool gap = gapEvery != 0 && step % gapEvery == gapEvery - 1;
+            for (Generator& generator : generators) {
+                if (gap) {
+                    generator.advance(step / gapEvery % 2 == 0 ? 3 : 200);
+                    continue;
+                }
+                MarketDataTick tick = generator.generateTick();
+                hash.add(static_cast<int64_t>(
+                    chrono::duration_cast<chrono::nanoseconds>(tick.timestamp.time_since_epoch()).count()));
+                hash.update(tick.symbol.data(), tick.symbol.size());
+                hash.add(tick.price);
+                hash.add(static_cast<int64_t>(tick.volume));
+                ++checksum.size;
+            }
+        }
+        checksum.hash = hash.digest();
+    });
+    return checksum;
+}
+
+void addStreams(map<string, Checksum>& results) {
+    results["stream mt19937/walk"] = streamChecksum<BasicMarketDataGenerator<mt19937>>(0);
+    results["stream mt19937/walk+gaps"] = streamChecksum<BasicMarketDataGenerator<mt19937>>(10);
+    results["stream minstd_rand/walk"] = streamChecksum<BasicMarketDataGenerator<minstd_rand>>(0);
+    results["stream minstd_rand/walk+gaps"] = streamChecksum<BasicMarketDataGenerator<minstd_rand>>(10);
+    results["stream mt19937_64/gbm"] = streamChecksum<BasicMarketDataGenerator<mt19937_64, GbmModel>>(0);
+    results["stream mt19937_64/gbm+gaps"] = streamChecksum<BasicMarketDataGenerator<mt19937_64, GbmModel>>(10);
+    results["stream philox/walk"] = streamChecksum<BasicMarketDataGenerator<Philox4x32>>(0);
+    results["stream philox/walk+gaps"] = streamChecksum<BasicMarketDataGenerator<Philox4x32>>(10);
+    results["stream prefill-mt19937_64/walk"] =
+        streamChecksum<BasicMarketDataGenerator<PrefilledEngine<mt19937_64>>>(0);
+}
+
+// --- Pipeline Outputs (Full Mode) ---
+// Hash of every file the run left in directory, in name order, each preceded by its name.
+Checksum directoryChecksum(const fs::path& directory) {
+    vector<fs::path> files;
+    for (const fs::directory_entry& entry : fs::directory_iterator(directory)) {
+        if (entry.is_regular_file()) {
+            files.push_back(entry.path());
+        }
+    }
+    sort(files.begin(), files.end());
+
+    Checksum checksum;
+    XxHash64 hash(kSeed);
+    vector<char> buffer(1 << 16);
+    for (const fs::path& file : files) {
+        string name = file.filename().string();
+        hash.update(name.data(), name.size() + 1); // With its terminator, so names and data cannot run together
+        ifstream in(file, ios::binary);
+        while (in.read(buffer.data(), static_cast<streamsize>(buffer.size())) || in.gcount() > 0) {
+            hash.update(buffer.data(), static_cast<size_t>(in.gcount()));
+            checksum.size += static_cast<uint64_t>(in.gcount());
+        }
+    }
+    checksum.hash = hash.digest();
+    return checksum;
+}
+
+// False if the pipeline itself failed; the case is then reported as changed.
+bool addOutput(map<string, Checksum>& results, const fs::path& root, const string& pipeline, size_t partitions) {
+    string name = pipeline + (partitions > 1 ? "/merge" + to_string(partitions) : "");
+    fs::path directory = root / (pipeline + (partitions > 1 ? ".merge" + to_string(partitions) : ""));
+    fs::create_directories(directory);
+
+    PipelineOptions options;
+    options.pipeline = pipeline;
+    options.output = (directory / "out.csv").string();
+    options.steps = kSteps;
+    options.delayMs = 0;
+    options.echo = false;
+    options.seed = kSeed;
+    options.symbols = kSymbols;
+    options.partitions = partitions;
+    options.merge = partitions > 1;
+    options.simulatedClock = true;
+
+    int status = 1;
+    runIsolated([&] { status = findPipeline(pipeline)->run(options); });
+    results["output " + name] = status == 0 ? directoryChecksum(directory) : Checksum{};
+    return status == 0;
+}
+
+void addOutputs(map<string, Checksum>& results, const fs::path& root) {
+    for (const PipelineEntry& entry : pipelineRegistry()) {
+        if (find(kUnfiled.begin(), kUnfiled.end(), entry.name) == kUnfiled.end()) {
+            addOutput(results, root, entry.name, 1);
+        }
+    }
+    // The k-way merge orders equal simulated timestamps by partition, so its output is fixed too
+    addOutput(results, root, "csv", 3);
+    addOutput(results, root, "csv-columnar", 3);
+}
+
+// --- Manifest ---
+// "<kind> <name> <xxh64> <size>" lines; '#' starts a comment.
+bool readManifest(const string& path, map<string, Checksum>& expected) {
+    ifstream in(path);
+    if (!in) {
+        return false;
+    }
+    string line;
+    while (getline(in, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        istringstream fields(line);
+        string kind, name, hash;
+        Checksum checksum;
+        if (fields >> kind >> name >> hash >> checksum.size) {
+            checksum.hash = stoull(hash, nullptr, 16);
+            expected[kind + " " + name] = checksum;
+        }
+    }
+    return true;
+}
+
+bool writeManifest(const string& path, const map<string, Checksum>& results) {
+    ofstream out(path);
+    out << "# Golden checksums for MarketDataSimulator --regress / --regress-fast (see regression.h).\n"
+        << "# seed " << kSeed << ", " << kSymbols << " symbols, " << kSteps << " steps, simulated clock, UTC.\n"
+        << "# Regenerate with --regress-update only for intended output changes.\n"
+        << "# kind name xxh64 size\n";
+    for (const auto& [key, checksum] : results) {
+        out << key << " " << hex64(checksum.hash) << " " << checksum.size << "\n";
+    }
+    return static_cast<bool>(out);
+}
+
+} // namespace
+
+int runRegression(const string& manifest, RegressionMode mode) {
+    // Timestamps are formatted in local time
+    setenv("TZ", "UTC", 1);
+    tzset();
+
+    map<string, Checksum> expected;
+    if (mode != RegressionMode::Update && !readManifest(manifest, expected)) {
+        cerr << "Error: could not read golden manifest " << manifest << endl;
+        return 1;
+    }
+
+    map<string, Checksum> results;
+    addStreams(results);
+    fs::path root = fs::temp_directory_path() / ("mds-regress-" + to_string(getpid()));
+    if (mode != RegressionMode::Fast) {
+        fs::remove_all(root);
+        addOutputs(results, root);
+    }
+
+    if (mode == RegressionMode::Update) {
+        fs::remove_all(root);
+        if (!writeManifest(manifest, results)) {
+            cerr << "Error: could not write golden manifest " << manifest << endl;
+            return 1;
+        }
+        cout << "[Regress] Wrote " << results.size() << " checksums to " << manifest << endl;
+        return 0;
+    }
+
+    size_t failures = 0;
+    for (const auto& [key, checksum] : results) {
+        auto found = expected.find(key);
+        if (found == expected.end()) {
+            cout << "[Regress] NEW      " << key << " " << hex64(checksum.hash) << " (not in the manifest)" << endl;
+            ++failures;
+        } else if (found->second.hash != checksum.hash || found->second.size != checksum.size) {
+            cout << "[Regress] CHANGED  " << key << ": expected " << hex64(found->second.hash) << " ("
+                 << found->second.size << "), got " << hex64(checksum.hash) << " (" << checksum.size << ")" << endl;
+            ++failures;
+        } else {
+            cout << "[Regress] ok       " << key << endl;
+        }
+    }
+    for (const auto& [key, checksum] : expected) {
+        bool checked = mode == RegressionMode::Full || key.rfind("stream ", 0) == 0;
+        if (checked && results.count(key) == 0) {
+            cout << "[Regress] MISSING  " << key << " (in the manifest, not produced)" << endl;
+            ++failures;
+        }
+    }
+
+    if (failures == 0) {
+        fs::remove_all(root);
+        cout << "[Regress] All " << results.size() << " checksums match " << manifest << endl;
+        return 0;
+    }
+    cout << "[Regress] " << failures << " of " << results.size() << " checksums differ from " << manifest;
+    if (mode == RegressionMode::Full) {
+        cout << "; outputs kept in " << root.string();
+    }
+    cout << endl;
+    return 1;
+}
@@ -0,0 +1,19 @@
+#ifndef MARKET_DATA_REGRESSION_H
+#define MARKET_DATA_REGRESSION_H
+
+#include <string>     // For std::string
+
+// --- Golden-Output Regression Checks ---
+// Runs a fixed, fully deterministic configuration (seed, 20-symbol universe, 100 steps, simulated
+// clock, UTC timestamps) and compares XXH64 checksums against a manifest such as golden.txt:
+//   Full   - every file-writing pipeline (plus merged partitions) to a scratch directory, hashing
+//            all output files, and every generator tick stream
+//   Fast   - the tick streams only: rolling XXH64 over the generated ticks, no queue or sink
+//   Update - rewrite the manifest from a full run, after an intended output change
+// Any mismatch, or a case missing from either side, fails with exit status 1; changed output
+// is kept for inspection.
+enum class RegressionMode { Full, Fast, Update };
+
+int runRegression(const std::string& manifest, RegressionMode mode);
+
+#endif // MARKET_DATA_REGRESSION_H
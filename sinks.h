@@ -0,0 +1,89 @@
+#ifndef MARKET_DATA_SINKS_H
+#define MARKET_DATA_SINKS_H
+
+#include <fstream>    // For std::ofstream
+#include <string>     // For std::string
+#include <vector>     // For std::vector
+
+// Sinks consume batches popped from the pipeline queue. Every sink is a class template over
+// its Formatter and provides:
+//   Sink(const std::string& path, Formatter& formatter) - opens and writes the header
+//   bool isOpen() const
+//   void writeBatch(std::vector<Item>& batch, Formatter& formatter)
+//        - may take the batch's contents (leaving it empty) instead of copying
+//   void flush()  - make everything written so far visible to readers
+//   void close()
+
+// --- Buffered File Sink ---
+// Formats a batch into one contiguous buffer and hands it to an ofstream.
+template <typename Formatter>
+class FileSink {
+public:
+    using Item = typename Formatter::Item;
+    static constexpr size_t kBufferSize = 1 << 16;
+
+    FileSink(const std::string& path, Formatter&)
+        : file_(path, std::ios::out | std::ios::trunc | std::ios::binary),
+          buffer_(kBufferSize)
+    {
+        file_ << Formatter::header();
+    }
+
+    bool isOpen() const { return file_.is_open(); }
+
+    void writeBatch(std::vector<Item>& batch, Formatter& formatter) {
+        char* begin = buffer_.data();
+        char* out = begin;
+        for (const Item& item : batch) {
+            size_t needed = Formatter::maxRecordSize(item);
+            if (static_cast<size_t>(out - begin) + needed > buffer_.size()) {
+                file_.write(begin, out - begin);
+                out = begin;
+                if (needed > buffer_.size()) {
+                    buffer_.resize(needed);
+                    begin = out = buffer_.data();
+                }
+            }
+            out = formatter.format(item, out);
+        }
+        file_.write(begin, out - begin);
+    }
+
+    void flush() { file_.flush(); }
+    void close() { file_.close(); }
+
+private:
+    std::ofstream file_;
+    std::vector<char> buffer_;
+};
+
+// --- Null Sink ---
+// Formats and discards: measures generation + formatting without any I/O.
+template <typename Formatter>
+class NullSink {
+public:
+    using Item = typename Formatter::Item;
+
+    NullSink(const std::string&, Formatter&) {}
+
+    bool isOpen() const { return true; }
+
+    void writeBatch(std::vector<Item>& batch, Formatter& formatter) {
+        for (const Item& item : batch) {
+            buffer_.resize(Formatter::maxRecordSize(item));
+            char* end = formatter.format(item, buffer_.data());
+            bytes_ += static_cast<size_t>(end - buffer_.data());
+        }
+    }
+
+    void flush() {}
+    void close() {}
+
+    size_t bytes() const { return bytes_; }
+
+private:
+    std::vector<char> buffer_;
+    size_t bytes_ = 0;
+};
+
+#endif // MARKET_DATA_SINKS_H
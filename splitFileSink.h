@@ -0,0 +1,369 @@
+#ifndef MARKET_DATA_SPLIT_FILE_SINK_H
+#define MARKET_DATA_SPLIT_FILE_SINK_H
+
+#include <cerrno>     // For errno, EINTR
+#include <atomic>     // For std::atomic
+#include <chrono>     // For std::chrono::steady_clock
+#include <condition_variable> // For std::condition_variable
+#include <cstdint>    // For uint64_t
+#include <cstring>    // For strerror, strlen, memcpy
+#include <functional> // For std::hash
+#include <list>       // For std::list
+#include <memory>     // For std::unique_ptr
+#include <mutex>      // For std::mutex
+#include <stdexcept>  // For std::runtime_error
+#include <string>     // For std::string
+#include <string_view> // For std::string_view
+#include <thread>     // For std::thread
+#include <unordered_map> // For std::unordered_map
+#include <vector>     // For std::vector
+#include <fcntl.h>    // For open
+#include <unistd.h>   // For write, close, access
+#include "perfCounters.h" // For per-stage hardware counters
+#include "threadSafeQueue.h" // For ThreadSafeQueue
+#include "trace.h"    // For MDS_TRACE_* trace points
+
+// --- Per-Symbol Split File Sink ---
+// Writes one file per symbol ("out.csv" -> "out.GOOG.csv", ...). The writer thread only formats
+// into per-symbol buffers; full buffers are handed to a small pool of flush threads. Each symbol
+// is always routed to the same flush thread, which keeps per-symbol order without locks, and
+// each flush thread keeps its own LRU of open descriptors so thousands of symbols never exceed
+// the open-file budget. Requires Formatter::symbolOf(const Item&) -> std::string_view.
+// Partial buffers are handed off by flush() at most every kPartialFlushInterval, so a writer
+// that flushes after every batch still hands the pool mostly full buffers (a pause in the
+// stream can hold the tails until the next write or close()); close() hands off everything,
+// then drains and joins the pool. At most kMaxJobsInFlight buffers wait for the flush threads:
+// past that the writer blocks until one is written, so memory stays at one staging buffer per
+// symbol plus the jobs in flight. The files are created lazily, so the constructor only checks
+// that their directory is writable. A flush thread that fails keeps draining its jobs, and the
+// error is raised on the writer thread by the next writeBatch/flush, or at the latest by close().
+template <typename Formatter>
+class SplitFileSink {
+public:
+    using Item = typename Formatter::Item;
+    static constexpr size_t kBufferBytes = 16 * 1024;  // Per-symbol staging buffer (10k symbols ~ 160 MB)
+    static constexpr size_t kDefaultFlushThreads = 2;
+    static constexpr size_t kDefaultMaxOpenFiles = 512; // Split evenly across flush threads
+    static constexpr size_t kMaxJobsInFlight = 64;      // Handed-off buffers not yet written (1 MB)
+    static constexpr std::chrono::milliseconds kPartialFlushInterval{100};
+
+    SplitFileSink(const std::string& path, Formatter&, size_t flushThreads = kDefaultFlushThreads,
+                  size_t maxOpenFiles = kDefaultMaxOpenFiles)
+        : header_(Formatter::header())
+    {
+        size_t dot = path.find_last_of('.');
+        size_t slash = path.find_last_of('/');
+        if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+            dot = path.size();
+        }
+        stem_ = path.substr(0, dot);
+        extension_ = path.substr(dot);
+        std::string directory = slash == std::string::npos ? "." : slash == 0 ? "/" : path.substr(0, slash);
+        if (::access(directory.c_str(), W_OK | X_OK) != 0) {
+            closed_ = true; // isOpen() is false; no flush threads to start
+            return;
+        }
+
+        if (flushThreads == 0) {
+            flushThreads = 1;
+        }
+        size_t filesPerThread = maxOpenFiles / flushThreads > 0 ? maxOpenFiles / flushThreads : 1;
+        for (size_t i = 0; i < flushThreads; ++i) {
+            workers_.push_back(std::make_unique<FlushWorker>(filesPerThread));
+        }
+        for (auto& worker : workers_) {
+            worker->thread = std::thread(&SplitFileSink::flushWorkerThread, this, std::ref(*worker));
+        }
+    }
+
+    ~SplitFileSink() {
+        try {
+            close();
+        } catch (const std::exception&) {
+            // Destructors must not throw; the writer already reported the failure
+        }
+    }
+
+    SplitFileSink(const SplitFileSink&) = delete;
+    SplitFileSink& operator=(const SplitFileSink&) = delete;
+
+    bool isOpen() const { return !closed_; }
+
+    void writeBatch(std::vector<Item>& batch, Formatter& formatter) {
+        throwIfFailed();
+        for (const Item& item : batch) {
+            SymbolOutput& output = outputFor(Formatter::symbolOf(item));
+            size_t needed = Formatter::maxRecordSize(item);
+            if (output.used + needed > kBufferBytes) {
+                if (needed > kBufferBytes) {
+                    throw std::runtime_error("record larger than the split sink buffer");
+                }
+                handOff(output);
+            }
+            char* begin = output.buffer.get();
+            output.used = static_cast<size_t>(formatter.format(item, begin + output.used) - begin);
+            ++output.records;
+            markDirty(output);
+        }
+    }
+
+    void flush() {
+        throwIfFailed();
+        auto now = std::chrono::steady_clock::now();
+        if (now - lastPartialFlush_ >= kPartialFlushInterval) {
+            lastPartialFlush_ = now;
+            handOffDirty();
+        }
+    }
+
+    // Throws if any write failed; the pool is drained and joined either way.
+    void close() {
+        if (closed_) {
+            return;
+        }
+        closed_ = true;
+        try {
+            if (!failed_) {
+                handOffDirty();
+            }
+        } catch (...) {
+            stopWorkers(); // Never leave joinable threads behind: ~thread would terminate
+            throw;
+        }
+        stopWorkers();
+        throwIfFailed();
+    }
+
+private:
+    struct FlushWorker;
+
+    using Buffer = std::unique_ptr<char[]>; // Always kBufferBytes, never zero-filled
+
+    struct SymbolOutput {
+        std::string path;
+        FlushWorker* worker = nullptr;
+        Buffer buffer;                       // Writer-thread side
+        size_t used = 0;
+        uint64_t records = 0;                // Formatted into buffer
+        bool dirty = false;                  // Listed in dirty_ (written since the last flush)
+        int fd = -1;                         // Flush-thread side from here on
+        bool created = false;
+        typename std::list<SymbolOutput*>::iterator lruPosition;
+    };
+
+    struct FlushJob {
+        SymbolOutput* output = nullptr;
+        Buffer data;
+        size_t length = 0;
+        uint64_t records = 0;
+    };
+
+    struct FlushWorker {
+        explicit FlushWorker(size_t maxOpen) : maxOpenFiles(maxOpen) {}
+
+        ThreadSafeQueue<FlushJob> jobs;
+        std::thread thread;
+        std::list<SymbolOutput*> lru;        // Front = most recently written
+        size_t maxOpenFiles;
+    };
+
+    SymbolOutput& outputFor(std::string_view symbol) {
+        // Consecutive ticks often share a symbol; skip the hash lookup for repeats
+        if (lastOutput_ != nullptr && symbol == lastSymbol_) {
+            return *lastOutput_;
+        }
+        std::string key(symbol);
+        auto found = outputs_.find(key);
+        if (found == outputs_.end()) {
+            auto output = std::make_unique<SymbolOutput>();
+            output->path = stem_ + "." + key + extension_;
+            output->worker = workers_[std::hash<std::string>()(key) % workers_.size()].get();
+            output->buffer = takeBuffer();
+            size_t headerLength = std::strlen(header_);
+            std::memcpy(output->buffer.get(), header_, headerLength);
+            output->used = headerLength;
+            markDirty(*output);
+            found = outputs_.emplace(std::move(key), std::move(output)).first;
+        }
+        lastSymbol_ = found->first;
+        lastOutput_ = found->second.get();
+        return *lastOutput_;
+    }
+
+    void markDirty(SymbolOutput& output) {
+        if (!output.dirty) {
+            output.dirty = true;
+            dirty_.push_back(&output);
+        }
+    }
+
+    // Lets the flush threads drain their jobs, then joins them.
+    void stopWorkers() {
+        for (auto& worker : workers_) {
+            worker->jobs.stop();
+        }
+        for (auto& worker : workers_) {
+            if (worker->thread.joinable()) {
+                worker->thread.join();
+            }
+        }
+    }
+
+    // Hands every partial buffer written since the last call to the pool.
+    void handOffDirty() {
+        for (SymbolOutput* output : dirty_) {
+            if (output->used > 0) {
+                handOff(*output);
+            }
+            output->dirty = false;
+        }
+        dirty_.clear();
+    }
+
+    // Blocks while kMaxJobsInFlight buffers are already waiting for the flush threads.
+    void handOff(SymbolOutput& output) {
+        {
+            std::unique_lock<std::mutex> lock(spareMutex_);
+            bufferReturned_.wait(lock, [this] { return jobsInFlight_ < kMaxJobsInFlight; });
+            ++jobsInFlight_;
+        }
+        FlushJob job;
+        job.output = &output;
+        job.data = std::move(output.buffer);
+        job.length = output.used;
+        job.records = output.records;
+        output.buffer = takeBuffer();
+        output.used = 0;
+        output.records = 0;
+        output.worker->jobs.push(std::move(job));
+    }
+
+    Buffer takeBuffer() {
+        {
+            std::lock_guard<std::mutex> lock(spareMutex_);
+            if (!spare_.empty()) {
+                Buffer buffer = std::move(spare_.back());
+                spare_.pop_back();
+                return buffer;
+            }
+        }
+        return Buffer(new char[kBufferBytes]);
+    }
+
+    void returnBuffer(Buffer&& buffer) {
+        {
+            std::lock_guard<std::mutex> lock(spareMutex_);
+            spare_.push_back(std::move(buffer));
+            --jobsInFlight_;
+        }
+        bufferReturned_.notify_one();
+    }
+
+    void throwIfFailed() {
+        if (failed_.load(std::memory_order_acquire)) {
+            std::lock_guard<std::mutex> lock(errorMutex_);
+            throw std::runtime_error("split sink: " + error_);
+        }
+    }
+
+    // --- Flush Threads ---
+    void flushWorkerThread(FlushWorker& worker) {
+        MDS_TRACE_THREAD_NAME("split_flush");
+        perf::PerfCounterGroup flushCounters;
+        flushCounters.start();
+        uint64_t recordsWritten = 0;
+        FlushJob job;
+        while (true) {
+            try {
+                worker.jobs.wait_and_pop(job);
+            } catch (const QueueStopped&) {
+                break; // Stopped and drained
+            }
+            if (!failed_.load(std::memory_order_relaxed)) { // After a failure, jobs are only drained
+                MDS_TRACE_SCOPE("split_write");
+                try {
+                    int fd = acquireDescriptor(worker, *job.output);
+                    writeAll(fd, job.data.get(), job.length);
+                    recordsWritten += job.records;
+                } catch (const std::runtime_error& e) {
+                    recordError(e.what());
+                }
+            }
+            returnBuffer(std::move(job.data));
+        }
+        for (SymbolOutput* output : worker.lru) {
+            ::close(output->fd);
+            output->fd = -1;
+        }
+        worker.lru.clear();
+
+        flushCounters.stop();
+        perf::recordStage("split_flush", flushCounters, recordsWritten);
+    }
+
+    // The first error wins; it is reported once, by the writer thread.
+    void recordError(const std::string& error) {
+        std::lock_guard<std::mutex> lock(errorMutex_);
+        if (!failed_.load(std::memory_order_relaxed)) {
+            error_ = error;
+            failed_.store(true, std::memory_order_release);
+        }
+    }
+
+    // Returns an open descriptor for output, evicting the least recently written file if needed.
+    static int acquireDescriptor(FlushWorker& worker, SymbolOutput& output) {
+        if (output.fd >= 0) {
+            worker.lru.splice(worker.lru.begin(), worker.lru, output.lruPosition);
+            return output.fd;
+        }
+        if (worker.lru.size() >= worker.maxOpenFiles) {
+            SymbolOutput* victim = worker.lru.back();
+            worker.lru.pop_back();
+            ::close(victim->fd);
+            victim->fd = -1;
+        }
+        int flags = O_WRONLY | O_CREAT | O_CLOEXEC | (output.created ? O_APPEND : O_TRUNC);
+        output.fd = ::open(output.path.c_str(), flags, 0644);
+        if (output.fd < 0) {
+            throw std::runtime_error("could not open " + output.path + ": " + std::strerror(errno));
+        }
+        output.created = true;
+        worker.lru.push_front(&output);
+        output.lruPosition = worker.lru.begin();
+        return output.fd;
+    }
+
+    static void writeAll(int fd, const char* data, size_t length) {
+        while (length > 0) {
+            ssize_t written = ::write(fd, data, length);
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw std::runtime_error(std::string("write failed: ") + std::strerror(errno));
+            }
+            data += written;
+            length -= static_cast<size_t>(written);
+        }
+    }
+
+    const char* header_;
+    std::string stem_;
+    std::string extension_;
+    std::vector<std::unique_ptr<FlushWorker>> workers_;
+    std::unordered_map<std::string, std::unique_ptr<SymbolOutput>> outputs_;
+    std::vector<SymbolOutput*> dirty_;
+    std::string_view lastSymbol_;
+    SymbolOutput* lastOutput_ = nullptr;
+    std::mutex spareMutex_;
+    std::condition_variable bufferReturned_;
+    std::vector<Buffer> spare_;             // At most kMaxJobsInFlight
+    size_t jobsInFlight_ = 0;               // Guarded by spareMutex_
+    std::chrono::steady_clock::time_point lastPartialFlush_{};
+    bool closed_ = false;
+    std::atomic<bool> failed_{false}; // Set by a flush thread on its first I/O error
+    std::mutex errorMutex_;
+    std::string error_;
+};
+
+#endif // MARKET_DATA_SPLIT_FILE_SINK_H
@@ -0,0 +1,155 @@
+#ifndef MARKET_DATA_SUBSCRIBER_INDEX_H
+#define MARKET_DATA_SUBSCRIBER_INDEX_H
+
+#include <algorithm>  // For std::copy_n
+#include <cstddef>    // For size_t
+#include <cstdint>    // For uint32_t, uint64_t
+#include <string>     // For std::string
+#include <string_view> // For std::string_view
+#include <unordered_map> // For std::unordered_map
+#include <vector>     // For std::vector
+#include "symbolDemand.h" // For SymbolDemand
+
+// --- Subscriber Index ---
+// Which client slots want which symbols, for the network fan-out servers. Each symbol has a
+// bitmap with one bit per slot plus a subscriber count, and wildcard subscribers have a bitmap
+// of their own. A record for a symbol nobody wants costs one check. Otherwise it costs one
+// word per 64 slots plus one visit per match. Not thread-safe: owned by a server's event loop.
+// An attached SymbolDemand mirrors the per-symbol counts for the producers.
+class SubscriberIndex {
+public:
+    SubscriberIndex() : allBits_(words_, 0) {}
+
+    // Dense id for symbol, interned on first sight. Records usually arrive in universe order,
+    // so the id after the previous lookup is tried before hashing.
+    uint32_t symbolId(std::string_view symbol) {
+        uint32_t id = nextId_;
+        if (id >= names_.size() || names_[id] != symbol) {
+            auto found = ids_.find(std::string(symbol));
+            if (found != ids_.end()) {
+                id = found->second;
+            } else {
+                id = static_cast<uint32_t>(names_.size());
+                names_.emplace_back(symbol);
+                ids_.emplace(names_.back(), id);
+                bits_.resize(bits_.size() + words_, 0);
+                counts_.push_back(0);
+            }
+        }
+        nextId_ = id + 1 < names_.size() ? id + 1 : 0;
+        return id;
+    }
+
+    size_t symbolCount() const { return names_.size(); }
+
+    // Makes room for slot; call before subscribing it.
+    void reserveSlot(uint32_t slot) {
+        while (slot >= words_ * 64) {
+            grow();
+        }
+    }
+
+    // Returns false if the slot already had that state.
+    bool subscribe(uint32_t slot, uint32_t symbol, bool subscribed) {
+        uint64_t& word = bits_[symbol * words_ + slot / 64];
+        uint64_t mask = 1ULL << (slot % 64);
+        if (subscribed == ((word & mask) != 0)) {
+            return false;
+        }
+        word ^= mask;
+        if (subscribed) {
+            ++counts_[symbol];
+        } else {
+            --counts_[symbol];
+        }
+        if (demand_) {
+            demand_->add(names_[symbol], subscribed ? 1 : -1);
+        }
+        return true;
+    }
+
+    bool subscribeAll(uint32_t slot, bool subscribed) {
+        uint64_t& word = allBits_[slot / 64];
+        uint64_t mask = 1ULL << (slot % 64);
+        if (subscribed == ((word & mask) != 0)) {
+            return false;
+        }
+        word ^= mask;
+        if (subscribed) {
+            ++allCount_;
+        } else {
+            --allCount_;
+        }
+        if (demand_) {
+            demand_->addWildcard(subscribed ? 1 : -1);
+        }
+        return true;
+    }
+
+    // Starts mirroring subscriptions into demand, beginning with the current ones.
+    void attachDemand(SymbolDemand& demand) {
+        demand_ = &demand;
+        for (size_t symbol = 0; symbol < names_.size(); ++symbol) {
+            if (counts_[symbol] != 0) {
+                demand.add(names_[symbol], static_cast<int32_t>(counts_[symbol]));
+            }
+        }
+        demand.addWildcard(static_cast<int32_t>(allCount_));
+    }
+
+    bool hasSubscribers(uint32_t symbol) const { return counts_[symbol] != 0 || allCount_ != 0; }
+    size_t wildcardCount() const { return allCount_; }
+
+    // Calls visit(slot) once for every slot subscribed to symbol, directly or by wildcard.
+    template <typename Visit>
+    void forEachSubscriber(uint32_t symbol, Visit visit) const {
+        if (!hasSubscribers(symbol)) {
+            return;
+        }
+        const uint64_t* bits = &bits_[symbol * words_];
+        for (size_t w = 0; w < words_; ++w) {
+            forEachBit(bits[w] | allBits_[w], w, visit);
+        }
+    }
+
+    template <typename Visit>
+    void forEachWildcard(Visit visit) const {
+        for (size_t w = 0; allCount_ != 0 && w < words_; ++w) {
+            forEachBit(allBits_[w], w, visit);
+        }
+    }
+
+private:
+    template <typename Visit>
+    static void forEachBit(uint64_t word, size_t w, Visit& visit) {
+        while (word != 0) {
+            uint32_t slot = static_cast<uint32_t>(w * 64 + __builtin_ctzll(word));
+            word &= word - 1;
+            visit(slot);
+        }
+    }
+
+    // Doubles the bitmap stride so every slot keeps its bit.
+    void grow() {
+        size_t words = words_ * 2;
+        std::vector<uint64_t> bits(names_.size() * words, 0);
+        for (size_t symbol = 0; symbol < names_.size(); ++symbol) {
+            std::copy_n(&bits_[symbol * words_], words_, &bits[symbol * words]);
+        }
+        bits_.swap(bits);
+        allBits_.resize(words, 0);
+        words_ = words;
+    }
+
+    std::unordered_map<std::string, uint32_t> ids_;
+    std::vector<std::string> names_;
+    size_t words_ = 1;                // 64-bit words per symbol bitmap
+    std::vector<uint64_t> bits_;      // names_.size() rows of words_
+    std::vector<uint32_t> counts_;
+    std::vector<uint64_t> allBits_;   // Wildcard subscribers
+    size_t allCount_ = 0;
+    uint32_t nextId_ = 0;
+    SymbolDemand* demand_ = nullptr;
+};
+
+#endif // MARKET_DATA_SUBSCRIBER_INDEX_H
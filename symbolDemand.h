@@ -0,0 +1,61 @@
+#ifndef MARKET_DATA_SYMBOL_DEMAND_H
+#define MARKET_DATA_SYMBOL_DEMAND_H
+
+#include <atomic>     // For std::atomic
+#include <cstddef>    // For size_t
+#include <cstdint>    // For uint32_t, int32_t
+#include <memory>     // For std::unique_ptr
+#include <string>     // For std::string
+#include <string_view> // For std::string_view
+#include <unordered_map> // For std::unordered_map
+#include <vector>     // For std::vector
+
+// --- Symbol Demand ---
+// Which symbols of the simulated universe anyone downstream wants, so the producers can skip
+// generating the rest. Demand-aware sinks (the subscriber servers) add and remove per-symbol
+// subscriber counts from their own threads. Several sinks may share one SymbolDemand, and the
+// counts simply add up. A wildcard subscription wants everything.
+//
+// Until track() is called, every symbol is wanted. File sinks never call it, so they see the
+// full stream.
+class SymbolDemand {
+public:
+    explicit SymbolDemand(const std::vector<std::string>& symbols)
+        : counts_(new std::atomic<int32_t>[symbols.size()]) {
+        for (size_t i = 0; i < symbols.size(); ++i) {
+            counts_[i].store(0, std::memory_order_relaxed);
+            ids_.emplace(symbols[i], static_cast<uint32_t>(i));
+        }
+    }
+
+    SymbolDemand(const SymbolDemand&) = delete;
+    SymbolDemand& operator=(const SymbolDemand&) = delete;
+
+    // From now on only subscribed symbols are wanted. Called before the producers start.
+    void track() { tracked_.store(true, std::memory_order_relaxed); }
+    bool tracked() const { return tracked_.load(std::memory_order_relaxed); }
+
+    // Producer side: one relaxed load per symbol per step. A change takes effect within a step.
+    bool wanted(uint32_t id) const {
+        return !tracked_.load(std::memory_order_relaxed) || wildcard_.load(std::memory_order_relaxed) > 0 ||
+               counts_[id].load(std::memory_order_relaxed) > 0;
+    }
+
+    // Subscriber side. Symbols outside the universe are ignored.
+    void add(std::string_view symbol, int32_t delta) {
+        auto found = ids_.find(std::string(symbol));
+        if (found != ids_.end()) {
+            counts_[found->second].fetch_add(delta, std::memory_order_relaxed);
+        }
+    }
+
+    void addWildcard(int32_t delta) { wildcard_.fetch_add(delta, std::memory_order_relaxed); }
+
+private:
+    std::unordered_map<std::string, uint32_t> ids_; // Immutable after construction
+    std::unique_ptr<std::atomic<int32_t>[]> counts_;
+    std::atomic<int32_t> wildcard_{0};
+    std::atomic<bool> tracked_{false};
+};
+
+#endif // MARKET_DATA_SYMBOL_DEMAND_H
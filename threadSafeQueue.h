@@ -0,0 +1,151 @@
+#ifndef MARKET_DATA_THREAD_SAFE_QUEUE_H
+#define MARKET_DATA_THREAD_SAFE_QUEUE_H
+
+#include <queue>      // For std::queue
+#include <mutex>      // For std::mutex
+#include <condition_variable> // For std::condition_variable
+#include <stdexcept>  // For std::runtime_error
+#include <vector>     // For std::vector (batch pops)
+#include "queueTelemetry.h" // For depth / stall / residency counters
+#include "trace.h"    // For MDS_TRACE_* hot-path trace points
+
+// Thrown by the blocking pops once stop() was called and the queue is drained. Derives from
+// std::runtime_error, so existing handlers keep working; catch it specifically to tell the
+// normal end of a stream from an I/O or other failure.
+class QueueStopped : public std::runtime_error {
+public:
+    QueueStopped() : std::runtime_error("ThreadSafeQueue stopped.") {}
+};
+
+// --- Thread-Safe Queue for MarketDataTick ---
+// This queue will allow the main thread (producer) to push ticks
+// and the writer thread (consumer) to pop ticks safely.
+// telemetry() can be read from any thread without taking the queue lock.
+template <typename T>
+class ThreadSafeQueue {
+public:
+    void push(T value) {
+        MDS_TRACE_SCOPE("queue_push");
+        std::unique_lock<std::mutex> lock(mtx_, std::try_to_lock); // Acquire lock
+        if (!lock.owns_lock()) {
+            // Contended: only now pay for the clock reads
+            uint64_t blockedFrom = QueueTelemetry::nowNs();
+            lock.lock();
+            telemetry_.addProducerBlocked(QueueTelemetry::nowNs() - blockedFrom);
+        }
+        uint64_t enqueuedNs = telemetry_.sampleNextPush() ? QueueTelemetry::nowNs() : kNotSampled;
+        queue_.push(Entry{std::move(value), enqueuedNs}); // Add item to queue
+        telemetry_.onPush(queue_.size());
+        cv_.notify_one();                      // Notify one waiting thread
+    }
+
+    // Attempts to pop an item without blocking. Returns true if successful, false otherwise.
+    bool try_pop(T& value) {
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (queue_.empty()) {
+            return false;
+        }
+        popFront(value);
+        return true;
+    }
+
+    // Pops an item, blocking if the queue is empty until an item is available or stop is signaled.
+    void wait_and_pop(T& value) {
+        MDS_TRACE_SCOPE("queue_pop");
+        std::unique_lock<std::mutex> lock = waitForItems();
+        popFront(value);
+    }
+
+    // Appends up to maxItems items to out without blocking. Returns the number popped.
+    size_t try_pop_batch(std::vector<T>& out, size_t maxItems) {
+        std::lock_guard<std::mutex> lock(mtx_);
+        return popBatch(out, maxItems);
+    }
+
+    // Like wait_and_pop, but drains up to maxItems items under a single lock acquisition.
+    size_t wait_and_pop_batch(std::vector<T>& out, size_t maxItems) {
+        MDS_TRACE_SCOPE("queue_pop_batch");
+        std::unique_lock<std::mutex> lock = waitForItems();
+        return popBatch(out, maxItems);
+    }
+
+    // Signals the queue to stop, causing waiting consumers to wake up and exit.
+    void stop() {
+        std::lock_guard<std::mutex> lock(mtx_);
+        stop_requested_ = true;
+        cv_.notify_all(); // Notify all waiting threads that stop has been requested
+    }
+
+    const QueueTelemetry& telemetry() const { return telemetry_; }
+
+private:
+    static constexpr uint64_t kNotSampled = 0;
+
+    struct Entry {
+        T value;
+        uint64_t enqueuedNs; // kNotSampled unless picked for the residency histogram
+    };
+
+    // Blocks until an item is available; throws once stop() was called and the queue is drained.
+    std::unique_lock<std::mutex> waitForItems() {
+        std::unique_lock<std::mutex> lock(mtx_, std::try_to_lock);
+        if (!lock.owns_lock() || (queue_.empty() && !stop_requested_)) {
+            // Idle: waiting for the lock or for a producer
+            uint64_t idleFrom = QueueTelemetry::nowNs();
+            if (!lock.owns_lock()) {
+                lock.lock();
+            }
+            // Wait until queue is not empty OR stop signal is received
+            cv_.wait(lock, [this] { return !queue_.empty() || stop_requested_; });
+            telemetry_.addConsumerIdle(QueueTelemetry::nowNs() - idleFrom);
+        }
+        MDS_TRACE_COUNTER("queue_depth", queue_.size());
+
+        if (stop_requested_ && queue_.empty()) {
+            // If stop was requested and queue is empty, we are done
+            // Re-notify to ensure other waiting threads also wake up and exit if needed
+            cv_.notify_all();
+            throw QueueStopped();
+        }
+        return lock;
+    }
+
+    // Caller holds mtx_.
+    size_t popBatch(std::vector<T>& out, size_t maxItems) {
+        size_t popped = 0;
+        uint64_t now = kNotSampled; // Read once, at the batch's first sampled item
+        while (popped < maxItems && !queue_.empty()) {
+            Entry& entry = queue_.front();
+            out.push_back(std::move(entry.value));
+            if (entry.enqueuedNs != kNotSampled) {
+                if (now == kNotSampled) {
+                    now = QueueTelemetry::nowNs();
+                }
+                telemetry_.recordResidency(entry.enqueuedNs, now);
+            }
+            queue_.pop();
+            telemetry_.onPop(queue_.size());
+            ++popped;
+        }
+        return popped;
+    }
+
+    // Caller holds mtx_ and has checked the queue is not empty.
+    void popFront(T& value) {
+        Entry& entry = queue_.front();
+        value = std::move(entry.value);
+        if (entry.enqueuedNs != kNotSampled) {
+            telemetry_.recordResidency(entry.enqueuedNs, QueueTelemetry::nowNs());
+        }
+        queue_.pop();
+        telemetry_.onPop(queue_.size());
+    }
+
+    std::queue<Entry> queue_;
+    std::mutex mtx_;
+    std::condition_variable cv_;
+    bool stop_requested_ = false; // Flag to signal threads to stop
+    QueueTelemetry telemetry_;
+};
+
+#endif // MARKET_DATA_THREAD_SAFE_QUEUE_H
@@ -0,0 +1,119 @@
+#include "throughputController.h"
+#include <algorithm>  // For max, min
+#include <iomanip>    // For fixed, setprecision
+#include <iostream>   // For cout
+#include <sstream>    // For ostringstream
+
+using namespace std;
+
+ThroughputController::ThroughputController(PipelineTuning& tuning, const QueueTelemetry& queueTelemetry,
+                                           const WriterLatency& writerLatency, double targetP99Us)
+    : tuning_(tuning),
+      queueTelemetry_(queueTelemetry),
+      writerLatency_(writerLatency),
+      targetP99Us_(targetP99Us),
+      lastQueue_(queueTelemetry.snapshot()),
+      lastLatency_(writerLatency.snapshot()),
+      lastTicks_(writerLatency.ticks())
+{}
+
+void ThroughputController::run(const atomic<bool>& running, chrono::milliseconds interval) {
+    auto previous = chrono::steady_clock::now();
+    while (running.load(memory_order_relaxed)) {
+        this_thread::sleep_for(interval);
+        auto now = chrono::steady_clock::now();
+        step(chrono::duration_cast<chrono::nanoseconds>(now - previous));
+        previous = now;
+    }
+}
+
+void ThroughputController::step(chrono::nanoseconds elapsed) {
+    QueueTelemetrySnapshot queue = queueTelemetry_.snapshot();
+    Log2Histogram latency = writerLatency_.snapshot();
+    uint64_t ticks = writerLatency_.ticks();
+
+    // Only look at what happened during this window.
+    Log2Histogram window;
+    uint64_t samples = 0;
+    for (int i = 0; i < kLog2HistogramBuckets; ++i) {
+        window[i] = latency[i] - lastLatency_[i];
+        samples += window[i];
+    }
+    double seconds = max(1e-9, chrono::duration<double>(elapsed).count());
+    double throughput = static_cast<double>(ticks - lastTicks_) / seconds;
+    double idleFraction = static_cast<double>(queue.consumerIdleNs - lastQueue_.consumerIdleNs) /
+                          max(1.0, static_cast<double>(elapsed.count()));
+    // A busy writer with a backlog: latency is queueing delay, and shrinking would only slow the drain.
+    bool backlogged = idleFraction < 0.05 && queue.depth > tuning_.batchSize.load(memory_order_relaxed);
+    bool backlogGrowing = backlogged && queue.depth > lastQueue_.depth;
+    lastQueue_ = queue;
+    lastLatency_ = latency;
+    lastTicks_ = ticks;
+
+    if (samples == 0) {
+        return; // Nothing flushed this window; no evidence to act on
+    }
+    double p99Us = static_cast<double>(histogramPercentileNs(window, 0.99)) / 1e3;
+
+    if (backlogGrowing) {
+        grow();
+        lastStepGrew_ = false; // Throughput comparisons are meaningless while draining a backlog
+        logDecision("grow (backlog)", p99Us, throughput);
+    } else if (backlogged) {
+        lastStepGrew_ = false; // Draining: hold the current settings
+    } else if (p99Us > targetP99Us_) {
+        shrink();
+        lastStepGrew_ = false;
+        logDecision("shrink (latency)", p99Us, throughput);
+    } else if (lastStepGrew_ && throughput < lastThroughput_ * 0.9) {
+        // The last growth step made things worse; back off instead of pushing further.
+        shrink();
+        lastStepGrew_ = false;
+        logDecision("shrink (throughput)", p99Us, throughput);
+    } else if (p99Us < targetP99Us_ * 0.5) {
+        grow();
+        lastStepGrew_ = true;
+        logDecision("grow", p99Us, throughput);
+    } else {
+        lastStepGrew_ = false;
+    }
+
+    // A writer that is parked most of the time gains nothing from spinning first.
+    uint32_t spin = tuning_.spinIterations.load(memory_order_relaxed);
+    if (idleFraction > 0.5 && spin > 0) {
+        tuning_.spinIterations.store(spin / 2, memory_order_relaxed);
+    }
+    lastThroughput_ = throughput;
+}
+
+void ThroughputController::grow() {
+    size_t batch = tuning_.batchSize.load(memory_order_relaxed);
+    tuning_.batchSize.store(min(PipelineTuning::kMaxBatchSize, batch * 2), memory_order_relaxed);
+
+    // Keep the flush interval well inside the latency budget.
+    uint32_t flushCap = static_cast<uint32_t>(min<double>(PipelineTuning::kMaxFlushIntervalUs, targetP99Us_ / 4));
+    uint32_t flush = tuning_.flushIntervalUs.load(memory_order_relaxed);
+    tuning_.flushIntervalUs.store(min(flushCap, flush == 0 ? 50u : flush * 2), memory_order_relaxed);
+}
+
+void ThroughputController::shrink() {
+    size_t batch = tuning_.batchSize.load(memory_order_relaxed);
+    tuning_.batchSize.store(max<size_t>(1, batch / 2), memory_order_relaxed);
+
+    uint32_t flush = tuning_.flushIntervalUs.load(memory_order_relaxed);
+    tuning_.flushIntervalUs.store(flush / 2, memory_order_relaxed);
+
+    // Spinning before parking trims wake-up latency at the cost of CPU.
+    uint32_t spin = tuning_.spinIterations.load(memory_order_relaxed);
+    tuning_.spinIterations.store(min(PipelineTuning::kMaxSpinIterations, spin * 2 + 64), memory_order_relaxed);
+}
+
+void ThroughputController::logDecision(const char* action, double p99Us, double ticksPerSecond) const {
+    ostringstream line;
+    line << "[Controller] " << action << fixed << setprecision(1)
+         << ": p99<=" << p99Us << "us rate=" << ticksPerSecond << "/s -> batch="
+         << tuning_.batchSize.load(memory_order_relaxed)
+         << " flush=" << tuning_.flushIntervalUs.load(memory_order_relaxed) << "us"
+         << " spin=" << tuning_.spinIterations.load(memory_order_relaxed);
+    cout << line.str() << endl;
+}
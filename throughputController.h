@@ -0,0 +1,85 @@
+#ifndef MARKET_DATA_THROUGHPUT_CONTROLLER_H
+#define MARKET_DATA_THROUGHPUT_CONTROLLER_H
+
+#include <atomic>     // For std::atomic
+#include <chrono>     // For std::chrono::milliseconds
+#include <cstddef>    // For size_t
+#include <cstdint>    // For uint32_t, uint64_t
+#include <thread>     // For std::this_thread::yield
+#include "queueTelemetry.h" // For QueueTelemetry, AtomicLog2Histogram
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h> // For _mm_pause
+#endif
+
+// Busy-wait hint used by spinning consumers.
+inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#else
+    std::this_thread::yield();
+#endif
+}
+
+// Runtime knobs of the generate -> queue -> write pipeline. Read by the writer on every batch,
+// written by ThroughputController. The defaults reproduce the original tick-at-a-time behavior.
+struct PipelineTuning {
+    static constexpr size_t kMaxBatchSize = 4096;
+    static constexpr uint32_t kMaxFlushIntervalUs = 100000;
+    static constexpr uint32_t kMaxSpinIterations = 20000;
+
+    std::atomic<size_t> batchSize{1};           // Max ticks popped per queue lock acquisition
+    std::atomic<uint32_t> flushIntervalUs{0};   // 0 = flush the output after every batch
+    std::atomic<uint32_t> spinIterations{0};    // try_pop polls before parking on the condition variable
+};
+
+// End-to-end latency (tick timestamp -> output flushed) and ticks written, recorded by the
+// writer thread. Ticks, not queue pops: a batching formatter's item carries many ticks.
+class WriterLatency {
+public:
+    void record(uint64_t ns) { histogram_.record(ns); }
+    Log2Histogram snapshot() const { return histogram_.snapshot(); }
+
+    void addTicks(uint64_t ticks) {
+        ticks_.store(ticks_.load(std::memory_order_relaxed) + ticks, std::memory_order_relaxed);
+    }
+    uint64_t ticks() const { return ticks_.load(std::memory_order_relaxed); }
+
+private:
+    AtomicLog2Histogram histogram_;
+    std::atomic<uint64_t> ticks_{0}; // Single writer, so a load/store pair cannot lose updates
+};
+
+// Feedback controller: maximizes throughput subject to p99 end-to-end latency <= target.
+// Each interval it looks at the latency and queue counters accumulated since the previous
+// decision and adjusts PipelineTuning multiplicatively: grow while the writer is saturated
+// or well under budget, shrink when over budget or when a growth step cost throughput.
+class ThroughputController {
+public:
+    ThroughputController(PipelineTuning& tuning, const QueueTelemetry& queueTelemetry,
+                         const WriterLatency& writerLatency, double targetP99Us);
+
+    // Runs control steps until running becomes false. Intended for a dedicated thread.
+    void run(const std::atomic<bool>& running, std::chrono::milliseconds interval);
+
+    // One control decision over the window since the previous call.
+    void step(std::chrono::nanoseconds elapsed);
+
+private:
+    void grow();
+    void shrink();
+    void logDecision(const char* action, double p99Us, double ticksPerSecond) const;
+
+    PipelineTuning& tuning_;
+    const QueueTelemetry& queueTelemetry_;
+    const WriterLatency& writerLatency_;
+    double targetP99Us_;
+
+    QueueTelemetrySnapshot lastQueue_;
+    Log2Histogram lastLatency_{};
+    uint64_t lastTicks_ = 0;
+    double lastThroughput_ = 0.0;
+    bool lastStepGrew_ = false;
+};
+
+#endif // MARKET_DATA_THROUGHPUT_CONTROLLER_H
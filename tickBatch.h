@@ -0,0 +1,217 @@
+#ifndef MARKET_DATA_TICK_BATCH_H
+#define MARKET_DATA_TICK_BATCH_H
+
+#include <algorithm>  // For std::copy_n, std::min, std::max
+#include <chrono>     // For std::chrono::system_clock
+#include <cstdint>    // For int64_t, uint32_t
+#include <cstring>    // For memcpy
+#include <limits>     // For std::numeric_limits
+#include <stdexcept>  // For std::out_of_range
+#include <string>     // For std::string
+#include <string_view> // For std::string_view
+#include <unordered_map> // For std::unordered_map
+#include <vector>     // For std::vector
+#include "fastFormat.h" // For fastfmt
+#include "marketData.h" // For MarketDataTick
+
+// --- Symbol Table ---
+// Dense uint32 ids for the simulated instruments. Built before the pipeline threads start and
+// read-only afterwards, so the producer and writer share it without locking.
+class SymbolTable {
+public:
+    SymbolTable() = default;
+    explicit SymbolTable(const std::vector<std::string>& symbols) {
+        for (const std::string& symbol : symbols) {
+            intern(symbol);
+        }
+    }
+
+    uint32_t intern(std::string_view symbol) {
+        auto found = ids_.find(std::string(symbol));
+        if (found != ids_.end()) {
+            return found->second;
+        }
+        uint32_t id = static_cast<uint32_t>(names_.size());
+        names_.emplace_back(symbol);
+        ids_.emplace(names_.back(), id);
+        maxLength_ = std::max(maxLength_, symbol.size());
+        return id;
+    }
+
+    uint32_t idOf(std::string_view symbol) const {
+        auto found = ids_.find(std::string(symbol));
+        if (found == ids_.end()) {
+            throw std::out_of_range("symbol not in table: " + std::string(symbol));
+        }
+        return found->second;
+    }
+
+    const std::string& name(uint32_t id) const { return names_[id]; }
+    size_t size() const { return names_.size(); }
+    size_t maxLength() const { return maxLength_; }
+
+private:
+    std::vector<std::string> names_;
+    std::unordered_map<std::string, uint32_t> ids_;
+    size_t maxLength_ = 0;
+};
+
+// --- Structure-of-Arrays Tick Batch ---
+// Up to Capacity ticks as parallel columns, so analytics, codecs and formatters run tight
+// per-column loops the compiler can vectorize. Copies and moves only touch the used prefix of
+// each column, which keeps queue transport cheap for partially filled batches.
+template <size_t Capacity>
+struct BasicTickBatch {
+    static constexpr size_t kCapacity = Capacity;
+
+    const SymbolTable* symbols = nullptr; // Resolves symbolIds; owned by the producer
+    size_t size = 0;
+    alignas(64) int64_t timestampNs[Capacity];
+    alignas(64) uint32_t symbolIds[Capacity];
+    alignas(64) double prices[Capacity];
+    alignas(64) int64_t volumes[Capacity];
+
+    BasicTickBatch() = default;
+    BasicTickBatch(const BasicTickBatch& other) { copyFrom(other); }
+    BasicTickBatch& operator=(const BasicTickBatch& other) {
+        if (this != &other) {
+            copyFrom(other);
+        }
+        return *this;
+    }
+
+    bool empty() const { return size == 0; }
+    bool full() const { return size == Capacity; }
+    void clear() { size = 0; }
+
+    void push(int64_t timestamp, uint32_t symbolId, double price, int64_t volume) {
+        timestampNs[size] = timestamp;
+        symbolIds[size] = symbolId;
+        prices[size] = price;
+        volumes[size] = volume;
+        ++size;
+    }
+
+    std::chrono::system_clock::time_point timestampAt(size_t row) const {
+        return std::chrono::system_clock::time_point(std::chrono::duration_cast<std::chrono::system_clock::duration>(
+            std::chrono::nanoseconds(timestampNs[row])));
+    }
+
+private:
+    void copyFrom(const BasicTickBatch& other) {
+        symbols = other.symbols;
+        size = other.size;
+        std::copy_n(other.timestampNs, size, timestampNs);
+        std::copy_n(other.symbolIds, size, symbolIds);
+        std::copy_n(other.prices, size, prices);
+        std::copy_n(other.volumes, size, volumes);
+    }
+};
+
+using TickBatch = BasicTickBatch<256>;
+
+// --- Columnar Kernels ---
+struct TickBatchSummary {
+    double minPrice = std::numeric_limits<double>::infinity();
+    double maxPrice = -std::numeric_limits<double>::infinity();
+    double notional = 0.0;  // Sum of price * volume
+    int64_t volume = 0;
+};
+
+// One pass per column; each loop is branch-free and vectorizes.
+template <size_t Capacity>
+TickBatchSummary summarize(const BasicTickBatch<Capacity>& batch) {
+    TickBatchSummary summary;
+    for (size_t i = 0; i < batch.size; ++i) {
+        summary.minPrice = std::min(summary.minPrice, batch.prices[i]);
+        summary.maxPrice = std::max(summary.maxPrice, batch.prices[i]);
+    }
+    for (size_t i = 0; i < batch.size; ++i) {
+        summary.notional += batch.prices[i] * static_cast<double>(batch.volumes[i]);
+    }
+    for (size_t i = 0; i < batch.size; ++i) {
+        summary.volume += batch.volumes[i];
+    }
+    return summary;
+}
+
+// --- Producer-Side Packing ---
+// Accumulates generated ticks into batches. Formatters whose Item is a batch expose it as
+// Formatter::Packer; the pipeline pushes a batch when it fills and at the end of every step.
+template <typename Batch>
+class TickBatchPacker {
+public:
+    explicit TickBatchPacker(const std::vector<std::string>& symbols) : table_(symbols) {
+        batch_.symbols = &table_;
+    }
+
+    // Not copyable: batches point at this packer's symbol table.
+    TickBatchPacker(const TickBatchPacker&) = delete;
+    TickBatchPacker& operator=(const TickBatchPacker&) = delete;
+
+    template <typename Queue>
+    void add(MarketDataTick&& tick, Queue& queue) {
+        batch_.push(std::chrono::duration_cast<std::chrono::nanoseconds>(tick.timestamp.time_since_epoch()).count(),
+                    symbolId(tick.symbol), tick.price, tick.volume);
+        if (batch_.full()) {
+            flush(queue);
+        }
+    }
+
+    template <typename Queue>
+    void flush(Queue& queue) {
+        if (!batch_.empty()) {
+            queue.push(batch_);
+            batch_.clear();
+        }
+    }
+
+    const SymbolTable& symbols() const { return table_; }
+
+private:
+    // Generators tick in universe order, so the next id is almost always the previous one + 1.
+    uint32_t symbolId(const std::string& symbol) {
+        uint32_t id = nextId_;
+        if (id >= table_.size() || table_.name(id) != symbol) {
+            id = table_.idOf(symbol);
+        }
+        nextId_ = id + 1 < table_.size() ? id + 1 : 0;
+        return id;
+    }
+
+    SymbolTable table_;
+    Batch batch_;
+    uint32_t nextId_ = 0;
+};
+
+// --- Tick Batch CSV Formatter ---
+// Same rows as FastCsvFormatter, read column-wise from a TickBatch.
+struct TickBatchCsvFormatter {
+    using Item = TickBatch;
+    using Packer = TickBatchPacker<TickBatch>;
+
+    // Batches never come from encode(); latency is tracked from a batch's first tick.
+    static std::chrono::system_clock::time_point timestampOf(const Item& batch) { return batch.timestampAt(0); }
+    static const char* header() { return "Timestamp,Symbol,Price,Volume\n"; }
+    static size_t tickCount(const Item& batch) { return batch.size; }
+
+    static size_t maxRecordSize(const Item& batch) { return batch.size * (batch.symbols->maxLength() + 80); }
+
+    char* format(const Item& batch, char* out) {
+        for (size_t i = 0; i < batch.size; ++i) {
+            out = fastfmt::writeTimestamp(batch.timestampAt(i), out);
+            *out++ = ',';
+            const std::string& symbol = batch.symbols->name(batch.symbolIds[i]);
+            std::memcpy(out, symbol.data(), symbol.size());
+            out += symbol.size();
+            *out++ = ',';
+            out = fastfmt::writeFixed<2>(batch.prices[i], out);
+            *out++ = ',';
+            out = fastfmt::writeSigned(batch.volumes[i], out);
+            *out++ = '\n';
+        }
+        return out;
+    }
+};
+
+#endif // MARKET_DATA_TICK_BATCH_H
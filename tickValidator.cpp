@@ -0,0 +1,120 @@
+#include "tickValidator.h"
+#include <chrono>     // For duration_cast
+#include <cmath>      // For nearbyint, fabs
+#include <cstring>    // For strnlen
+#include <limits>     // For numeric_limits
+
+using namespace std;
+
+// --- Gathering Columns ---
+void TickValidator::check(const vector<MarketDataTick>& batch) {
+    resizeScratch(batch.size());
+    for (size_t i = 0; i < batch.size(); ++i) {
+        const MarketDataTick& tick = batch[i];
+        timestamps_[i] = chrono::duration_cast<chrono::nanoseconds>(tick.timestamp.time_since_epoch()).count();
+        ids_[i] = symbolId(tick.symbol);
+        prices_[i] = tick.price;
+        volumes_[i] = tick.volume;
+    }
+    checkColumns(timestamps_.data(), ids_.data(), prices_.data(), volumes_.data(), batch.size());
+}
+
+void TickValidator::check(const vector<TickRecord>& batch) {
+    resizeScratch(batch.size());
+    for (size_t i = 0; i < batch.size(); ++i) {
+        const TickRecord& record = batch[i];
+        timestamps_[i] = binrec::storeInt(record.timestampNs); // Same byte swap in both directions
+        ids_[i] = symbolId(string_view(record.symbol, strnlen(record.symbol, sizeof(record.symbol))));
+        prices_[i] = binrec::storeDouble(record.price);
+        volumes_[i] = binrec::storeInt(record.volume);
+    }
+    checkColumns(timestamps_.data(), ids_.data(), prices_.data(), volumes_.data(), batch.size());
+}
+
+// Already columnar: only the symbol ids are translated, since batches from different
+// partitions number their symbols independently.
+void TickValidator::check(const vector<TickBatch>& batch) {
+    for (const TickBatch& columns : batch) {
+        vector<uint32_t>& remap = remaps_[columns.symbols];
+        resizeScratch(columns.size);
+        for (size_t i = 0; i < columns.size; ++i) {
+            uint32_t local = columns.symbolIds[i];
+            while (local >= remap.size()) {
+                remap.push_back(symbolId(columns.symbols->name(static_cast<uint32_t>(remap.size()))));
+            }
+            ids_[i] = remap[local];
+        }
+        checkColumns(columns.timestampNs, ids_.data(), columns.prices, columns.volumes, columns.size);
+    }
+}
+
+// Grows only: the columns are overwritten, never cleared.
+void TickValidator::resizeScratch(size_t count) {
+    if (ids_.size() < count) {
+        timestamps_.resize(count);
+        ids_.resize(count);
+        prices_.resize(count);
+        volumes_.resize(count);
+    }
+}
+
+uint32_t TickValidator::symbolId(string_view symbol) {
+    uint32_t id = nextId_;
+    if (id >= symbols_.size() || symbols_.name(id) != symbol) {
+        id = symbols_.intern(symbol);
+        if (id >= last_.size()) {
+            last_.push_back({numeric_limits<int64_t>::min(), numeric_limits<int64_t>::min()});
+        }
+    }
+    nextId_ = id + 1 < symbols_.size() ? id + 1 : 0;
+    return id;
+}
+
+// --- Checks ---
+void TickValidator::checkColumns(const int64_t* timestamps, const uint32_t* ids, const double* prices,
+                                 const int64_t* volumes, size_t count) {
+    counts_.ticks += count;
+
+    // Per-column counts: no branches, so each loop vectorizes
+    uint64_t badPrices = 0;
+    for (size_t i = 0; i < count; ++i) {
+        badPrices += !(prices[i] > 0.0 && prices[i] <= numeric_limits<double>::max()); // NaN fails both
+    }
+    uint64_t badVolumes = 0;
+    for (size_t i = 0; i < count; ++i) {
+        badVolumes += volumes[i] <= 0;
+    }
+    uint64_t offGrid = 0;
+    if (tickSize_ > 0.0) {
+        double inverse = 1.0 / tickSize_;
+        for (size_t i = 0; i < count; ++i) {
+            double ticks = prices[i] * inverse;
+            offGrid += fabs(ticks - nearbyint(ticks)) > 1e-6;
+        }
+    }
+    counts_.badPrices += badPrices;
+    counts_.badVolumes += badVolumes;
+    counts_.offGridPrices += offGrid;
+
+    // Per-symbol order: gather the previous tick, compare, scatter this one
+    uint64_t regressions = 0;
+    uint64_t breaks = 0;
+    for (size_t i = 0; i < count; ++i) {
+        SymbolState& last = last_[ids[i]];
+        regressions += timestamps[i] < last.timestamp;
+        breaks += volumes[i] <= last.volume;
+        last = {timestamps[i], volumes[i]};
+    }
+    counts_.timestampRegressions += regressions;
+    counts_.sequenceBreaks += breaks;
+}
+
+void TickValidator::print(ostream& out, const string& label) const {
+    out << "[Validate] " << label << ": " << counts_.ticks << " ticks, " << counts_.violations() << " violations";
+    if (counts_.violations() != 0) {
+        out << " (bad price " << counts_.badPrices << ", off grid " << counts_.offGridPrices << ", bad volume "
+            << counts_.badVolumes << ", timestamp regressions " << counts_.timestampRegressions
+            << ", sequence breaks " << counts_.sequenceBreaks << ")";
+    }
+    out << endl;
+}
@@ -0,0 +1,88 @@
+#ifndef MARKET_DATA_TICK_VALIDATOR_H
+#define MARKET_DATA_TICK_VALIDATOR_H
+
+#include <cstddef>    // For size_t
+#include <cstdint>    // For int64_t, uint32_t, uint64_t
+#include <ostream>    // For std::ostream
+#include <string>     // For std::string
+#include <string_view> // For std::string_view
+#include <type_traits> // For std::false_type, std::void_t
+#include <unordered_map> // For std::unordered_map
+#include <utility>    // For std::declval
+#include <vector>     // For std::vector
+#include "binaryRecord.h" // For TickRecord
+#include "marketData.h" // For MarketDataTick
+#include "tickBatch.h" // For TickBatch, SymbolTable
+
+// --- Violation Counters ---
+struct ValidationCounts {
+    uint64_t ticks = 0;
+    uint64_t badPrices = 0;            // Not finite or not positive
+    uint64_t offGridPrices = 0;        // Not a multiple of the tick size (when one is set)
+    uint64_t badVolumes = 0;           // Not positive
+    uint64_t timestampRegressions = 0; // Earlier than the symbol's previous tick
+    uint64_t sequenceBreaks = 0;       // Cumulative volume not above the symbol's previous tick:
+                                       // a duplicated, replayed or reordered tick
+
+    uint64_t violations() const {
+        return badPrices + offGridPrices + badVolumes + timestampRegressions + sequenceBreaks;
+    }
+};
+
+// --- Tick Validator ---
+// Invariant checks between the queue and the sink (--validate), for soak runs. Each writer batch
+// is gathered into columns. Price, grid and volume checks are then branch-free per-column count
+// loops, which vectorize. Per-symbol ordering needs the symbol's previous timestamp and volume,
+// so that pass is a gather/compare/scatter over symbol ids. Violations are counted, never
+// thrown: the run completes and the counts are reported at the end.
+class TickValidator {
+public:
+    // tickSize > 0 also checks that prices lie on that grid (within 1e-6 ticks).
+    explicit TickValidator(double tickSize = 0.0) : tickSize_(tickSize) {}
+
+    void check(const std::vector<MarketDataTick>& batch);
+    void check(const std::vector<TickRecord>& batch);
+    void check(const std::vector<TickBatch>& batch);
+
+    const ValidationCounts& counts() const { return counts_; }
+
+    // "[Validate] <label>: N ticks, ... violations"
+    void print(std::ostream& out, const std::string& label) const;
+
+    // Runs the checks over columns already filled in; public for benchmarks.
+    void checkColumns(const int64_t* timestamps, const uint32_t* ids, const double* prices, const int64_t* volumes,
+                      size_t count);
+
+private:
+    uint32_t symbolId(std::string_view symbol);
+    void resizeScratch(size_t count);
+
+    double tickSize_;
+    ValidationCounts counts_;
+
+    SymbolTable symbols_;
+    uint32_t nextId_ = 0; // Ticks usually arrive in universe order: try the id after the last one first
+    std::unordered_map<const SymbolTable*, std::vector<uint32_t>> remaps_; // TickBatch ids -> symbols_ ids
+
+    struct SymbolState {
+        int64_t timestamp; // Of the symbol's previous tick
+        int64_t volume;
+    };
+    std::vector<SymbolState> last_; // By id; one cache line access per tick
+
+    // Scratch columns for the current batch
+    std::vector<int64_t> timestamps_;
+    std::vector<uint32_t> ids_;
+    std::vector<double> prices_;
+    std::vector<int64_t> volumes_;
+};
+
+// Items TickValidator can check; others (e.g. MarketEvent) run unvalidated.
+template <typename Item, typename = void>
+struct IsValidatable : std::false_type {};
+
+template <typename Item>
+struct IsValidatable<Item, std::void_t<decltype(std::declval<TickValidator&>().check(
+                               std::declval<const std::vector<Item>&>()))>> : std::true_type {};
+
+#endif // MARKET_DATA_TICK_VALIDATOR_H
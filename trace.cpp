@@ -0,0 +1,181 @@
+#include "trace.h"
+#include <algorithm>  // For find_if, min
+#include <deque>      // For deque
+#include <fstream>    // For ofstream
+#include <iostream>   // For cout, cerr
+#include <memory>     // For unique_ptr
+#include <mutex>      // For mutex
+#include <vector>     // For vector
+
+using namespace std;
+
+namespace trace {
+
+namespace {
+
+// A buffer outlives its thread so a dump after join() still sees it; only the dump recycles it.
+struct Registry {
+    vector<unique_ptr<ThreadBuffer>> buffers; // Live and retired, dumped in this order
+    deque<ThreadBuffer*> retired;             // Threads exited since the last dump, oldest first
+    vector<unique_ptr<ThreadBuffer>> spare;   // Dumped, ready for a new thread
+    uint32_t nextThreadId = 1;
+    uint64_t evictedEvents = 0;               // Undumped events of retired buffers taken over
+};
+
+mutex& registryMutex() {
+    static mutex mtx;
+    return mtx;
+}
+
+Registry& registry() {
+    static Registry instance;
+    return instance;
+}
+
+ThreadBuffer* acquireBuffer() {
+    lock_guard<mutex> lock(registryMutex());
+    Registry& reg = registry();
+    uint32_t threadId = reg.nextThreadId++;
+    if (!reg.spare.empty()) {
+        reg.buffers.push_back(move(reg.spare.back()));
+        reg.spare.pop_back();
+        reg.buffers.back()->reuse(threadId);
+    } else if (reg.retired.size() >= MDS_TRACE_RETIRED_BUFFERS) {
+        ThreadBuffer* oldest = reg.retired.front();
+        reg.retired.pop_front();
+        reg.evictedEvents += min(oldest->written(), ThreadBuffer::kCapacity);
+        oldest->reuse(threadId);
+        return oldest;
+    } else {
+        reg.buffers.push_back(make_unique<ThreadBuffer>(threadId));
+    }
+    return reg.buffers.back().get();
+}
+
+// Retires the thread's buffer when the thread exits.
+struct Registration {
+    ThreadBuffer* buffer = nullptr;
+
+    ~Registration() {
+        lock_guard<mutex> lock(registryMutex());
+        registry().retired.push_back(buffer);
+    }
+};
+
+// Moves the buffers of exited threads to the spare list. Caller holds registryMutex().
+void recycleRetired(Registry& reg) {
+    for (ThreadBuffer* buffer : reg.retired) {
+        auto found = find_if(reg.buffers.begin(), reg.buffers.end(),
+                             [buffer](const unique_ptr<ThreadBuffer>& owned) { return owned.get() == buffer; });
+        reg.spare.push_back(move(*found));
+        reg.buffers.erase(found);
+    }
+    reg.retired.clear();
+}
+
+void writeJsonString(ostream& out, const char* text) {
+    out << '"';
+    for (const char* p = text; *p != '\0'; ++p) {
+        if (*p == '"' || *p == '\\') {
+            out << '\\';
+        }
+        out << *p;
+    }
+    out << '"';
+}
+
+} // namespace
+
+ThreadBuffer::ThreadBuffer(uint32_t threadId) : threadId_(threadId) {}
+
+void ThreadBuffer::reuse(uint32_t threadId) {
+    threadId_ = threadId;
+    written_ = 0;
+    threadName_.clear();
+}
+
+ThreadBuffer& threadBuffer() {
+    // The hot path only reads a trivial thread_local; the one with a destructor is touched once.
+    thread_local ThreadBuffer* buffer = nullptr;
+    if (buffer == nullptr) {
+        thread_local Registration registration;
+        buffer = acquireBuffer();
+        registration.buffer = buffer;
+    }
+    return *buffer;
+}
+
+void setThreadName(const char* name) {
+    threadBuffer().setThreadName(name);
+}
+
+bool dumpChromeTrace(const string& filename) {
+    ofstream out(filename, ios::out | ios::trunc);
+    if (!out.is_open()) {
+        cerr << "Error: could not open trace file " << filename << " for writing." << endl;
+        return false;
+    }
+
+    lock_guard<mutex> lock(registryMutex());
+    Registry& reg = registry();
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+    bool first = true;
+    uint64_t dropped = reg.evictedEvents;
+    reg.evictedEvents = 0;
+
+    for (const auto& buffer : reg.buffers) {
+        if (!buffer->threadName().empty()) {
+            out << (first ? "" : ",\n")
+                << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->threadId()
+                << ",\"args\":{\"name\":";
+            writeJsonString(out, buffer->threadName().c_str());
+            out << "}}";
+            first = false;
+        }
+
+        uint64_t written = buffer->written();
+        uint64_t begin = written > ThreadBuffer::kCapacity ? written - ThreadBuffer::kCapacity : 0;
+        dropped += begin;
+
+        // After wrap-around the oldest surviving events may be ends whose begins were overwritten.
+        int depth = 0;
+        for (uint64_t i = begin; i < written; ++i) {
+            const Event& event = buffer->at(i);
+            if (event.phase == Phase::End) {
+                if (depth == 0) {
+                    continue;
+                }
+                --depth;
+            } else if (event.phase == Phase::Begin) {
+                ++depth;
+            }
+
+            out << (first ? "" : ",\n") << "{\"name\":";
+            writeJsonString(out, event.name);
+            out << ",\"ph\":\"" << static_cast<char>(event.phase) << "\""
+                << ",\"ts\":" << event.timestampNs / 1000 << '.'
+                << static_cast<char>('0' + (event.timestampNs / 100) % 10)
+                << static_cast<char>('0' + (event.timestampNs / 10) % 10)
+                << static_cast<char>('0' + event.timestampNs % 10)
+                << ",\"pid\":1,\"tid\":" << buffer->threadId();
+            if (event.phase == Phase::Instant) {
+                out << ",\"s\":\"t\",\"args\":{\"value\":" << event.arg << "}";
+            } else if (event.phase == Phase::Counter) {
+                out << ",\"args\":{\"value\":" << event.arg << "}";
+            }
+            out << "}";
+            first = false;
+        }
+    }
+
+    out << "\n]}\n";
+    recycleRetired(reg);
+    cout << "[Trace] Wrote " << filename;
+    if (dropped > 0) {
+        cout << " (" << dropped << " oldest events overwritten)";
+    }
+    cout << endl;
+    return static_cast<bool>(out);
+}
+
+} // namespace trace
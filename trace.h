@@ -0,0 +1,129 @@
+#ifndef MARKET_DATA_TRACE_H
+#define MARKET_DATA_TRACE_H
+
+#include <cstdint>    // For uint64_t, uint8_t
+#include <string>     // For std::string
+#include <chrono>     // For std::chrono::steady_clock
+
+// Compile-time switch for the hot-path trace points. When disabled (the default)
+// every MDS_TRACE_* macro expands to nothing, so release builds pay zero cost.
+#ifndef MDS_ENABLE_TRACE
+#define MDS_ENABLE_TRACE 0
+#endif
+
+// Number of events kept per thread. Must be a power of two; older events are overwritten.
+#ifndef MDS_TRACE_BUFFER_EVENTS
+#define MDS_TRACE_BUFFER_EVENTS (1u << 16)
+#endif
+
+// Buffers of exited threads kept for the next dump. A dump hands them to new threads; past this
+// many, a new thread takes over the oldest one and its undumped events are dropped.
+#ifndef MDS_TRACE_RETIRED_BUFFERS
+#define MDS_TRACE_RETIRED_BUFFERS 16
+#endif
+
+namespace trace {
+
+// Chrome trace event phases we emit.
+enum class Phase : uint8_t {
+    Begin = 'B',
+    End = 'E',
+    Instant = 'i',
+    Counter = 'C'
+};
+
+// Fixed-size binary event. Names must be string literals (only the pointer is stored).
+struct Event {
+    uint64_t timestampNs;
+    const char* name;
+    uint64_t arg;
+    Phase phase;
+};
+
+// Single-writer ring buffer owned by one thread. No locks, no formatting.
+class ThreadBuffer {
+public:
+    static constexpr uint64_t kCapacity = MDS_TRACE_BUFFER_EVENTS;
+    static_assert((kCapacity & (kCapacity - 1)) == 0, "MDS_TRACE_BUFFER_EVENTS must be a power of two");
+
+    explicit ThreadBuffer(uint32_t threadId);
+
+    // Empties the buffer for a new thread.
+    void reuse(uint32_t threadId);
+
+    void record(Phase phase, const char* name, uint64_t arg) {
+        Event& event = events_[written_ & (kCapacity - 1)];
+        event.timestampNs = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+        event.name = name;
+        event.arg = arg;
+        event.phase = phase;
+        ++written_;
+    }
+
+    uint32_t threadId() const { return threadId_; }
+    uint64_t written() const { return written_; }
+    const Event& at(uint64_t index) const { return events_[index & (kCapacity - 1)]; }
+
+    const std::string& threadName() const { return threadName_; }
+    void setThreadName(std::string name) { threadName_ = std::move(name); }
+
+private:
+    uint32_t threadId_;
+    uint64_t written_ = 0;
+    std::string threadName_;
+    Event events_[kCapacity];
+};
+
+// Returns the calling thread's buffer, registering it on first use (the only locked step).
+// The buffer is retired when the thread exits and recycled after the next dump.
+ThreadBuffer& threadBuffer();
+
+inline void record(Phase phase, const char* name, uint64_t arg = 0) {
+    threadBuffer().record(phase, name, arg);
+}
+
+// Labels the calling thread in the dumped trace.
+void setThreadName(const char* name);
+
+// Writes every registered buffer as Chrome trace / Perfetto JSON, then recycles the buffers of
+// exited threads. Call only after the traced threads have been joined.
+bool dumpChromeTrace(const std::string& filename);
+
+// RAII begin/end pair.
+class Scope {
+public:
+    explicit Scope(const char* name) : name_(name) { record(Phase::Begin, name_); }
+    ~Scope() { record(Phase::End, name_); }
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+private:
+    const char* name_;
+};
+
+} // namespace trace
+
+#define MDS_TRACE_CONCAT_INNER(a, b) a##b
+#define MDS_TRACE_CONCAT(a, b) MDS_TRACE_CONCAT_INNER(a, b)
+
+#if MDS_ENABLE_TRACE
+#define MDS_TRACE_SCOPE(name) ::trace::Scope MDS_TRACE_CONCAT(traceScope_, __LINE__)(name)
+#define MDS_TRACE_BEGIN(name) ::trace::record(::trace::Phase::Begin, name)
+#define MDS_TRACE_END(name) ::trace::record(::trace::Phase::End, name)
+#define MDS_TRACE_INSTANT(name, arg) ::trace::record(::trace::Phase::Instant, name, static_cast<uint64_t>(arg))
+#define MDS_TRACE_COUNTER(name, value) ::trace::record(::trace::Phase::Counter, name, static_cast<uint64_t>(value))
+#define MDS_TRACE_THREAD_NAME(name) ::trace::setThreadName(name)
+#define MDS_TRACE_DUMP(filename) ::trace::dumpChromeTrace(filename)
+#else
+#define MDS_TRACE_SCOPE(name) ((void)0)
+#define MDS_TRACE_BEGIN(name) ((void)0)
+#define MDS_TRACE_END(name) ((void)0)
+#define MDS_TRACE_INSTANT(name, arg) ((void)0)
+#define MDS_TRACE_COUNTER(name, value) ((void)0)
+#define MDS_TRACE_THREAD_NAME(name) ((void)0)
+#define MDS_TRACE_DUMP(filename) ((void)0)
+#endif
+
+#endif // MARKET_DATA_TRACE_H
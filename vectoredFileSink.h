@@ -0,0 +1,155 @@
+#ifndef MARKET_DATA_VECTORED_FILE_SINK_H
+#define MARKET_DATA_VECTORED_FILE_SINK_H
+
+#include <atomic>     // For std::atomic
+#include <cerrno>     // For errno, EINTR, ENOSYS
+#include <cstring>    // For strerror
+#include <stdexcept>  // For std::runtime_error
+#include <string>     // For std::string
+#include <type_traits> // For std::is_trivially_copyable
+#include <utility>    // For std::swap
+#include <vector>     // For std::vector
+#include <fcntl.h>    // For open
+#include <sys/uio.h>  // For writev, pwritev2, iovec
+#include <unistd.h>   // For close
+
+// Writes every iovec completely, resuming after short writes.
+// Uses pwritev2 at the current file offset where the C library has it, else writev.
+inline void writeAllVectored(int fd, iovec* iov, int count) {
+    while (count > 0) {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 26))
+        static std::atomic<bool> havePwritev2{true};
+        bool usePwritev2 = havePwritev2.load(std::memory_order_relaxed);
+        ssize_t written = usePwritev2 ? pwritev2(fd, iov, count, -1, 0) : writev(fd, iov, count);
+        if (written < 0 && errno == ENOSYS && usePwritev2) {
+            havePwritev2.store(false, std::memory_order_relaxed); // Old kernel: fall back for the rest of the run
+            continue;
+        }
+#else
+        ssize_t written = writev(fd, iov, count);
+#endif
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::runtime_error(std::string("writev failed: ") + std::strerror(errno));
+        }
+        size_t remaining = static_cast<size_t>(written);
+        while (count > 0 && remaining >= iov->iov_len) {
+            remaining -= iov->iov_len;
+            ++iov;
+            --count;
+        }
+        if (count > 0) {
+            iov->iov_base = static_cast<char*>(iov->iov_base) + remaining;
+            iov->iov_len -= remaining;
+        }
+    }
+}
+
+// --- Vectored File Sink ---
+// Zero-formatting fast path for fixed-width records: the writer's batch vectors are adopted
+// as-is and submitted together with one gather write, so ticks are never copied or
+// formatted after leaving the queue. Requires a trivially copyable Formatter::Item.
+template <typename Formatter>
+class VectoredFileSink {
+public:
+    using Item = typename Formatter::Item;
+    static_assert(std::is_trivially_copyable<Item>::value, "VectoredFileSink writes Items as raw bytes");
+
+    static constexpr size_t kMaxPendingBatches = 64;       // iovecs per syscall (well under IOV_MAX)
+    static constexpr size_t kMaxPendingBytes = 1 << 20;    // Submit early once this much is queued
+
+    VectoredFileSink(const std::string& path, Formatter&)
+        : fd_(::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644))
+    {
+        const char* header = Formatter::header();
+        if (fd_ >= 0 && header[0] != '\0') {
+            header_.assign(header);
+            iovec iov{&header_[0], header_.size()};
+            try {
+                writeAllVectored(fd_, &iov, 1);
+            } catch (...) {
+                ::close(fd_); // No destructor runs for a throwing constructor
+                throw;
+            }
+        }
+    }
+
+    ~VectoredFileSink() {
+        try {
+            close();
+        } catch (const std::exception&) {
+            // Destructors must not throw; the writer already reported the failure
+        }
+    }
+
+    VectoredFileSink(const VectoredFileSink&) = delete;
+    VectoredFileSink& operator=(const VectoredFileSink&) = delete;
+
+    bool isOpen() const { return fd_ >= 0; }
+
+    // Takes ownership of the batch's buffer; hands back a recycled (empty) one.
+    void writeBatch(std::vector<Item>& batch, Formatter&) {
+        if (batch.empty()) {
+            return;
+        }
+        pendingBytes_ += batch.size() * sizeof(Item);
+        pending_.emplace_back();
+        std::swap(pending_.back(), batch);
+        if (!spare_.empty()) {
+            std::swap(batch, spare_.back());
+            spare_.pop_back();
+        }
+        if (pending_.size() >= kMaxPendingBatches || pendingBytes_ >= kMaxPendingBytes) {
+            submit();
+        }
+    }
+
+    void flush() { submit(); }
+
+    // The descriptor is closed even when the final write throws.
+    void close() {
+        if (fd_ < 0) {
+            return;
+        }
+        try {
+            submit();
+        } catch (...) {
+            ::close(fd_);
+            fd_ = -1;
+            throw;
+        }
+        ::close(fd_);
+        fd_ = -1;
+    }
+
+private:
+    void submit() {
+        if (pending_.empty()) {
+            return;
+        }
+        iov_.clear();
+        for (std::vector<Item>& buffer : pending_) {
+            iov_.push_back(iovec{buffer.data(), buffer.size() * sizeof(Item)});
+        }
+        writeAllVectored(fd_, iov_.data(), static_cast<int>(iov_.size()));
+
+        // Keep the buffers (and their capacity) for the writer to reuse
+        for (std::vector<Item>& buffer : pending_) {
+            buffer.clear();
+            spare_.push_back(std::move(buffer));
+        }
+        pending_.clear();
+        pendingBytes_ = 0;
+    }
+
+    int fd_;
+    std::string header_;
+    std::vector<std::vector<Item>> pending_;
+    std::vector<std::vector<Item>> spare_;
+    std::vector<iovec> iov_;
+    size_t pendingBytes_ = 0;
+};
+
+#endif // MARKET_DATA_VECTORED_FILE_SINK_H
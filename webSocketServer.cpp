@@ -0,0 +1,749 @@
+#include "webSocketServer.h"
+#include <array>      // For array
+#include <cctype>     // For tolower, isxdigit
+#include <cerrno>     // For errno, EAGAIN, EINTR
+#include <chrono>     // For steady_clock
+#include <cstring>    // For strerror, memcpy
+#include <iostream>
+#include <string_view> // For string_view
+#include "netUtil.h"  // For listenOn, setNonBlocking
+#include "perfCounters.h" // For per-stage hardware counters
+#include "trace.h"    // For MDS_TRACE_THREAD_NAME
+
+#include <netinet/in.h> // For IPPROTO_TCP
+#include <netinet/tcp.h> // For TCP_NODELAY
+#include <sys/epoll.h> // For epoll_create1, epoll_ctl, epoll_wait
+#include <sys/eventfd.h> // For eventfd
+#include <sys/socket.h> // For accept4, recv, send, setsockopt
+#include <unistd.h>   // For read, write, close, unlink
+
+using namespace std;
+
+namespace {
+
+constexpr uint64_t kListenTag = ~0ULL;
+constexpr uint64_t kWakeTag = ~0ULL - 1;
+constexpr uint32_t kWildcard = ~0U;
+constexpr size_t kMaxHandshakeBytes = 8 * 1024;
+constexpr size_t kMaxFramePayload = 64 * 1024; // Client frames are short commands
+constexpr size_t kFrameBatchBytes = 64 * 1024;
+constexpr chrono::milliseconds kCloseGrace(1000);
+
+constexpr uint8_t kOpText = 0x1;
+constexpr uint8_t kOpBinary = 0x2;
+constexpr uint8_t kOpClose = 0x8;
+constexpr uint8_t kOpPing = 0x9;
+constexpr uint8_t kOpPong = 0xA;
+
+void watch(int epollFd, int op, int fd, uint32_t events, uint64_t tag) {
+    epoll_event event = {};
+    event.events = events;
+    event.data.u64 = tag;
+    epoll_ctl(epollFd, op, fd, &event);
+}
+
+// --- Handshake Helpers ---
+uint32_t rotateLeft(uint32_t value, int bits) { return (value << bits) | (value >> (32 - bits)); }
+
+// SHA-1 of message; only used for Sec-WebSocket-Accept.
+array<uint8_t, 20> sha1(const string& message) {
+    uint32_t h[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+    string data = message;
+    uint64_t bitLength = static_cast<uint64_t>(message.size()) * 8;
+    data.push_back(static_cast<char>(0x80));
+    while (data.size() % 64 != 56) {
+        data.push_back('\0');
+    }
+    for (int shift = 56; shift >= 0; shift -= 8) {
+        data.push_back(static_cast<char>(bitLength >> shift));
+    }
+
+    for (size_t block = 0; block < data.size(); block += 64) {
+        uint32_t w[80];
+        for (int i = 0; i < 16; ++i) {
+            const unsigned char* p = reinterpret_cast<const unsigned char*>(&data[block + i * 4]);
+            w[i] = (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | uint32_t(p[3]);
+        }
+        for (int i = 16; i < 80; ++i) {
+            w[i] = rotateLeft(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+        }
+        uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+        for (int i = 0; i < 80; ++i) {
+            uint32_t f, k;
+            if (i < 20) {
+                f = (b & c) | (~b & d);
+                k = 0x5A827999;
+            } else if (i < 40) {
+                f = b ^ c ^ d;
+                k = 0x6ED9EBA1;
+            } else if (i < 60) {
+                f = (b & c) | (b & d) | (c & d);
+                k = 0x8F1BBCDC;
+            } else {
+                f = b ^ c ^ d;
+                k = 0xCA62C1D6;
+            }
+            uint32_t next = rotateLeft(a, 5) + f + e + k + w[i];
+            e = d;
+            d = c;
+            c = rotateLeft(b, 30);
+            b = a;
+            a = next;
+        }
+        h[0] += a;
+        h[1] += b;
+        h[2] += c;
+        h[3] += d;
+        h[4] += e;
+    }
+
+    array<uint8_t, 20> digest;
+    for (int i = 0; i < 20; ++i) {
+        digest[i] = static_cast<uint8_t>(h[i / 4] >> (24 - (i % 4) * 8));
+    }
+    return digest;
+}
+
+string base64(const uint8_t* data, size_t length) {
+    static const char kAlphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    string out;
+    for (size_t i = 0; i < length; i += 3) {
+        uint32_t group = uint32_t(data[i]) << 16;
+        if (i + 1 < length) {
+            group |= uint32_t(data[i + 1]) << 8;
+        }
+        if (i + 2 < length) {
+            group |= data[i + 2];
+        }
+        out.push_back(kAlphabet[(group >> 18) & 63]);
+        out.push_back(kAlphabet[(group >> 12) & 63]);
+        out.push_back(i + 1 < length ? kAlphabet[(group >> 6) & 63] : '=');
+        out.push_back(i + 2 < length ? kAlphabet[group & 63] : '=');
+    }
+    return out;
+}
+
+string acceptKey(const string& key) {
+    array<uint8_t, 20> digest = sha1(key + "258EAFA5-E914-47DA-95CA-C5AB0DC85B11");
+    return base64(digest.data(), digest.size());
+}
+
+// Value of an HTTP header (case-insensitive name), trimmed; empty if absent.
+string headerValue(const string& request, const string& name) {
+    size_t line = request.find("\r\n");
+    while (line != string::npos && line + 2 < request.size()) {
+        size_t start = line + 2;
+        size_t end = request.find("\r\n", start);
+        size_t colon = request.find(':', start);
+        if (colon != string::npos && colon < end && colon - start == name.size()) {
+            bool match = true;
+            for (size_t i = 0; i < name.size() && match; ++i) {
+                match = tolower(static_cast<unsigned char>(request[start + i])) == name[i];
+            }
+            if (match) {
+                size_t valueStart = request.find_first_not_of(' ', colon + 1);
+                size_t valueEnd = request.find_last_not_of(' ', end - 1);
+                return valueStart <= valueEnd ? request.substr(valueStart, valueEnd - valueStart + 1) : string();
+            }
+        }
+        line = end;
+    }
+    return string();
+}
+
+// "GOOG%2CAAPL" -> "GOOG,AAPL"
+string percentDecode(string_view text) {
+    string out;
+    for (size_t i = 0; i < text.size(); ++i) {
+        if (text[i] == '%' && i + 2 < text.size() && isxdigit(static_cast<unsigned char>(text[i + 1])) &&
+            isxdigit(static_cast<unsigned char>(text[i + 2]))) {
+            out.push_back(static_cast<char>(stoi(string(text.substr(i + 1, 2)), nullptr, 16)));
+            i += 2;
+        } else {
+            out.push_back(text[i] == '+' ? ' ' : text[i]);
+        }
+    }
+    return out;
+}
+
+void appendFrameHeader(string& out, uint8_t opcode, size_t length) {
+    out.push_back(static_cast<char>(0x80 | opcode)); // FIN: never fragmented
+    if (length < 126) {
+        out.push_back(static_cast<char>(length));
+    } else if (length <= 0xFFFF) {
+        out.push_back(static_cast<char>(126));
+        out.push_back(static_cast<char>(length >> 8));
+        out.push_back(static_cast<char>(length));
+    } else {
+        out.push_back(static_cast<char>(127));
+        for (int shift = 56; shift >= 0; shift -= 8) {
+            out.push_back(static_cast<char>(static_cast<uint64_t>(length) >> shift));
+        }
+    }
+}
+
+// Text frame holding "[" + records + "]".
+void appendArrayFrame(string& out, const string& records) {
+    appendFrameHeader(out, kOpText, records.size() + 2);
+    out.push_back('[');
+    out.append(records);
+    out.push_back(']');
+}
+
+} // namespace
+
+// --- Setup and Shutdown ---
+WebSocketServer::WebSocketServer(const string& address, const string&) {
+    try {
+        net::Endpoint endpoint = net::parseEndpoint(address);
+        listenFd_ = net::listenOn(endpoint);
+        unixPath_ = endpoint.tcp ? "" : endpoint.path;
+        net::setNonBlocking(listenFd_);
+    } catch (const exception& e) {
+        cerr << "[WebSocket] " << e.what() << endl;
+        if (listenFd_ >= 0) {
+            ::close(listenFd_);
+            listenFd_ = -1;
+        }
+        return;
+    }
+    epollFd_ = epoll_create1(EPOLL_CLOEXEC);
+    wakeFd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    watch(epollFd_, EPOLL_CTL_ADD, listenFd_, EPOLLIN, kListenTag);
+    watch(epollFd_, EPOLL_CTL_ADD, wakeFd_, EPOLLIN, kWakeTag);
+    cout << "[WebSocket] Serving ws://" << address << "/?symbols=..." << endl;
+    loopThread_ = thread(&WebSocketServer::eventLoop, this);
+}
+
+WebSocketServer::~WebSocketServer() {
+    close();
+}
+
+FeedChunk WebSocketServer::acquireChunk() {
+    lock_guard<mutex> lock(mutex_);
+    if (spare_.empty()) {
+        return FeedChunk();
+    }
+    FeedChunk chunk = move(spare_.back());
+    spare_.pop_back();
+    return chunk;
+}
+
+void WebSocketServer::publish(FeedChunk&& chunk) {
+    bool wake;
+    {
+        lock_guard<mutex> lock(mutex_);
+        wake = published_.empty(); // Otherwise a wakeup is already pending
+        published_.push_back(move(chunk));
+    }
+    if (wake) {
+        uint64_t one = 1;
+        ssize_t ignored = write(wakeFd_, &one, sizeof(one));
+        (void)ignored;
+    }
+}
+
+void WebSocketServer::trackDemand(SymbolDemand& demand) {
+    {
+        lock_guard<mutex> lock(mutex_);
+        pendingDemand_ = &demand;
+    }
+    uint64_t one = 1;
+    ssize_t ignored = write(wakeFd_, &one, sizeof(one));
+    (void)ignored;
+}
+
+void WebSocketServer::close() {
+    if (loopThread_.joinable()) {
+        {
+            lock_guard<mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        uint64_t one = 1;
+        ssize_t ignored = write(wakeFd_, &one, sizeof(one));
+        (void)ignored;
+        loopThread_.join();
+        cout << "[WebSocket] " << connectionsAccepted_ << " connections served, " << recordsPublished_
+             << " records published, " << recordsDelivered_ << " deliveries in " << framesSent_ << " frames, "
+             << recordsConflated_ << " conflated, " << bytesSent_ << " bytes sent" << endl;
+    }
+    for (int* fd : {&listenFd_, &epollFd_, &wakeFd_}) {
+        if (*fd >= 0) {
+            ::close(*fd);
+            *fd = -1;
+        }
+    }
+    if (!unixPath_.empty()) {
+        unlink(unixPath_.c_str());
+        unixPath_.clear();
+    }
+}
+
+// --- Event Loop ---
+void WebSocketServer::eventLoop() {
+    MDS_TRACE_THREAD_NAME("websocket");
+    perf::PerfCounterGroup publisherCounters;
+    publisherCounters.start();
+    epoll_event events[256];
+    bool draining = false;
+    auto deadline = chrono::steady_clock::now();
+
+    while (true) {
+        int ready = epoll_wait(epollFd_, events, 256, draining ? 20 : -1);
+        if (ready < 0 && errno != EINTR) {
+            cerr << "[WebSocket] epoll_wait: " << strerror(errno) << endl;
+            break;
+        }
+        for (int i = 0; i < ready; ++i) {
+            uint64_t tag = events[i].data.u64;
+            if (tag == kListenTag) {
+                acceptConnections();
+            } else if (tag == kWakeTag) {
+                uint64_t count;
+                ssize_t ignored = read(wakeFd_, &count, sizeof(count));
+                (void)ignored;
+            } else if (connections_[tag]) {
+                if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+                    readInput(*connections_[tag]);
+                }
+                if (connections_[tag] && (events[i].events & EPOLLOUT)) {
+                    flushConnection(*connections_[tag]);
+                }
+            }
+        }
+
+        bool stopping = drainPublished();
+        if (stopping && !draining) {
+            draining = true; // Everything is fanned out: say goodbye and give clients a moment
+            deadline = chrono::steady_clock::now() + kCloseGrace;
+            for (auto& connection : connections_) {
+                if (connection && connection->open && !connection->closing) {
+                    const char goingAway[] = {char(0x03), char(0xE9)}; // Status 1001
+                    appendFrame(*connection, kOpClose, goingAway, sizeof(goingAway));
+                    connection->closing = true;
+                    markDirty(*connection);
+                }
+            }
+        }
+        writeFrames();
+        freeSlots_.insert(freeSlots_.end(), released_.begin(), released_.end());
+        released_.clear();
+
+        if (draining) {
+            bool pending = false;
+            for (const auto& connection : connections_) {
+                pending = pending || (connection && connection->queued() > 0);
+            }
+            if (!pending || chrono::steady_clock::now() >= deadline) {
+                break;
+            }
+        }
+    }
+    for (uint32_t slot = 0; slot < connections_.size(); ++slot) {
+        if (connections_[slot]) {
+            disconnect(slot);
+        }
+    }
+
+    publisherCounters.stop();
+    perf::recordStage("publisher/ws", publisherCounters, recordsPublished_);
+}
+
+bool WebSocketServer::drainPublished() {
+    vector<FeedChunk> chunks;
+    bool stopping;
+    SymbolDemand* demand;
+    {
+        lock_guard<mutex> lock(mutex_);
+        chunks.swap(published_);
+        stopping = stopping_;
+        demand = pendingDemand_;
+        pendingDemand_ = nullptr;
+    }
+    if (demand) {
+        subscribers_.attachDemand(*demand);
+    }
+    // A loop that fell behind batches more records per frame, but hands out frames every
+    // kFrameBatchBytes so clients that cannot keep up start conflating early.
+    size_t batched = 0;
+    for (FeedChunk& chunk : chunks) {
+        fanOut(chunk);
+        batched += chunk.data.size();
+        if (batched >= kFrameBatchBytes) {
+            writeFrames();
+            batched = 0;
+        }
+        chunk.clear();
+    }
+    if (!chunks.empty()) {
+        lock_guard<mutex> lock(mutex_);
+        for (FeedChunk& chunk : chunks) {
+            spare_.push_back(move(chunk));
+        }
+    }
+    return stopping;
+}
+
+void WebSocketServer::acceptConnections() {
+    while (true) {
+        int fd = accept4(listenFd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                cerr << "[WebSocket] accept: " << strerror(errno) << endl;
+            }
+            return;
+        }
+        int noDelay = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay)); // Fails harmlessly on Unix sockets
+
+        uint32_t slot;
+        if (!freeSlots_.empty()) {
+            slot = freeSlots_.back();
+            freeSlots_.pop_back();
+        } else {
+            slot = static_cast<uint32_t>(connections_.size());
+            connections_.emplace_back();
+            subscribers_.reserveSlot(slot);
+        }
+        connections_[slot] = make_unique<Connection>(fd, slot);
+        ++connectionsAccepted_;
+        watch(epollFd_, EPOLL_CTL_ADD, fd, EPOLLIN, slot);
+    }
+}
+
+void WebSocketServer::disconnect(uint32_t slot) {
+    Connection& connection = *connections_[slot];
+    epoll_ctl(epollFd_, EPOLL_CTL_DEL, connection.fd, nullptr);
+    ::close(connection.fd);
+    while (!connection.symbols.empty()) {
+        setSubscribed(connection, connection.symbols.back(), false);
+    }
+    connections_[slot].reset();
+    released_.push_back(slot);
+}
+
+// --- Client Input ---
+void WebSocketServer::readInput(Connection& connection) {
+    char chunk[4096];
+    while (true) {
+        ssize_t n = recv(connection.fd, chunk, sizeof(chunk), 0);
+        if (n > 0) {
+            connection.input.append(chunk, static_cast<size_t>(n));
+            continue;
+        }
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        }
+        disconnect(connection.slot); // EOF or reset
+        return;
+    }
+    bool keep = connection.open ? readFrames(connection) : handshake(connection);
+    if (keep && connection.open && !connection.input.empty()) {
+        keep = readFrames(connection); // Frames pipelined right behind the handshake
+    }
+    if (!keep) {
+        disconnect(connection.slot);
+    }
+}
+
+bool WebSocketServer::handshake(Connection& connection) {
+    size_t end = connection.input.find("\r\n\r\n");
+    if (end == string::npos) {
+        return connection.input.size() <= kMaxHandshakeBytes;
+    }
+    string request = connection.input.substr(0, end + 4);
+    connection.input.erase(0, end + 4);
+
+    string key = headerValue(request, "sec-websocket-key");
+    if (request.compare(0, 4, "GET ") != 0 || key.empty()) {
+        connection.output += "HTTP/1.1 400 Bad Request\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+        connection.closing = true;
+        markDirty(connection);
+        return true;
+    }
+    connection.output += "HTTP/1.1 101 Switching Protocols\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"
+                         "Sec-WebSocket-Accept: " + acceptKey(key) + "\r\n\r\n";
+    connection.open = true;
+    markDirty(connection);
+
+    // GET /?symbols=GOOG,AAPL
+    size_t target = request.find(' ') + 1;
+    string path = request.substr(target, request.find(' ', target) - target);
+    size_t query = path.find("symbols=");
+    if (query != string::npos && (query == 0 || path[query - 1] == '?' || path[query - 1] == '&')) {
+        size_t valueStart = query + 8;
+        size_t valueEnd = path.find('&', valueStart);
+        handleCommand(connection, "SUB " + percentDecode(string_view(path).substr(valueStart, valueEnd - valueStart)));
+    }
+    return true;
+}
+
+// Parses every complete client frame; false on a protocol violation.
+bool WebSocketServer::readFrames(Connection& connection) {
+    string& input = connection.input;
+    while (input.size() >= 2) {
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(input.data());
+        uint8_t opcode = bytes[0] & 0x0F;
+        bool masked = (bytes[1] & 0x80) != 0;
+        uint64_t length = bytes[1] & 0x7F;
+        size_t header = 2;
+        if (length == 126) {
+            if (input.size() < 4) {
+                return true;
+            }
+            length = (uint64_t(bytes[2]) << 8) | bytes[3];
+            header = 4;
+        } else if (length == 127) {
+            if (input.size() < 10) {
+                return true;
+            }
+            length = 0;
+            for (int i = 2; i < 10; ++i) {
+                length = (length << 8) | bytes[i];
+            }
+            header = 10;
+        }
+        if (length > kMaxFramePayload) {
+            return false;
+        }
+        size_t maskOffset = header;
+        header += masked ? 4 : 0;
+        if (input.size() < header + length) {
+            return true;
+        }
+        string payload = input.substr(header, length);
+        if (masked) {
+            for (size_t i = 0; i < payload.size(); ++i) {
+                payload[i] = static_cast<char>(payload[i] ^ input[maskOffset + i % 4]);
+            }
+        }
+        input.erase(0, header + length);
+
+        if (opcode == kOpText || opcode == kOpBinary) {
+            handleCommand(connection, payload);
+        } else if (opcode == kOpClose) {
+            if (!connection.closing) {
+                appendFrame(connection, kOpClose, payload.data(), min<size_t>(payload.size(), 2)); // Echo the status
+                connection.closing = true;
+                markDirty(connection);
+            }
+            input.clear();
+            return true;
+        } else if (opcode == kOpPing) {
+            appendFrame(connection, kOpPong, payload.data(), payload.size());
+            markDirty(connection);
+        }
+    }
+    return true;
+}
+
+// "SUB GOOG,AAPL" / "UNSUB *", as on the TCP feed.
+void WebSocketServer::handleCommand(Connection& connection, const string& text) {
+    size_t space = text.find(' ');
+    string command = text.substr(0, space);
+    if (command != "SUB" && command != "UNSUB") {
+        const char error[] = "{\"error\":\"unknown command\"}";
+        appendFrame(connection, kOpText, error, sizeof(error) - 1);
+        markDirty(connection);
+        return;
+    }
+    bool subscribe = command == "SUB";
+    size_t start = space == string::npos ? text.size() : space + 1;
+    while (start < text.size()) {
+        size_t end = text.find_first_of(" ,", start);
+        if (end == string::npos) {
+            end = text.size();
+        }
+        if (end > start) {
+            string_view symbol = string_view(text).substr(start, end - start);
+            setSubscribed(connection, symbol == "*" ? kWildcard : subscribers_.symbolId(symbol), subscribe);
+        }
+        start = end + 1;
+    }
+}
+
+void WebSocketServer::setSubscribed(Connection& connection, uint32_t symbol, bool subscribed) {
+    bool changed = symbol == kWildcard ? subscribers_.subscribeAll(connection.slot, subscribed)
+                                       : subscribers_.subscribe(connection.slot, symbol, subscribed);
+    if (!changed) {
+        return;
+    }
+    if (symbol == kWildcard) {
+        connection.all = subscribed;
+    }
+    if (subscribed) {
+        connection.symbols.push_back(symbol);
+        return;
+    }
+    for (uint32_t& id : connection.symbols) {
+        if (id == symbol) {
+            id = connection.symbols.back();
+            connection.symbols.pop_back();
+            break;
+        }
+    }
+}
+
+// --- Fan-Out ---
+void WebSocketServer::fanOut(const FeedChunk& chunk) {
+    for (const FeedChunk::Record& record : chunk.records) {
+        ++recordsPublished_;
+        uint32_t symbol = subscribers_.symbolId(string_view(chunk.symbols).substr(record.symbolOffset,
+                                                                                   record.symbolLength));
+        const char* data = chunk.data.data() + record.offset;
+        size_t length = record.length;
+        if (length > 0 && data[length - 1] == '\n') {
+            --length; // NDJSON record -> array element
+        }
+        if (subscribers_.wildcardCount() > 0) {
+            if (!broadcast_.empty()) {
+                broadcast_.push_back(',');
+            }
+            broadcast_.append(data, length);
+        }
+        subscribers_.forEachSubscriber(symbol, [&](uint32_t slot) {
+            deliver(*connections_[slot], symbol, data, length);
+        });
+    }
+}
+
+void WebSocketServer::deliver(Connection& connection, uint32_t symbol, const char* data, size_t length) {
+    if (!connection.open || connection.closing) {
+        return;
+    }
+    if (connection.conflating) {
+        if (connection.latest.size() <= symbol) {
+            connection.latest.resize(subscribers_.symbolCount());
+        }
+        string& latest = connection.latest[symbol];
+        if (latest.empty()) {
+            connection.conflated.push_back(symbol);
+        } else {
+            ++recordsConflated_;
+        }
+        latest.assign(data, length);
+        return;
+    }
+    ++recordsDelivered_;
+    if (connection.all) {
+        return; // Gets the shared wildcard frame
+    }
+    if (!connection.batch.empty()) {
+        connection.batch.push_back(',');
+    }
+    connection.batch.append(data, length);
+    markDirty(connection);
+}
+
+void WebSocketServer::markDirty(Connection& connection) {
+    if (!connection.dirty) {
+        connection.dirty = true;
+        dirty_.push_back(connection.slot);
+    }
+}
+
+// Turns this iteration's records into one frame per connection and starts sending them.
+void WebSocketServer::writeFrames() {
+    if (!broadcast_.empty()) {
+        string frame;
+        appendArrayFrame(frame, broadcast_);
+        broadcast_.clear();
+        subscribers_.forEachWildcard([&](uint32_t slot) {
+            Connection& connection = *connections_[slot];
+            if (connection.open && !connection.closing && !connection.conflating) {
+                connection.output.append(frame);
+                ++framesSent_;
+                markDirty(connection);
+            }
+        });
+    }
+    for (size_t i = 0; i < dirty_.size(); ++i) { // flushConnection may append (conflated frames)
+        uint32_t slot = dirty_[i];
+        if (!connections_[slot]) {
+            continue;
+        }
+        Connection& connection = *connections_[slot];
+        connection.dirty = false;
+        if (!connection.batch.empty()) {
+            appendArrayFrame(connection.output, connection.batch);
+            ++framesSent_;
+            connection.batch.clear();
+        }
+        flushConnection(connection);
+        if (connections_[slot] && connection.queued() > kConflateAboveBytes) {
+            connection.conflating = true; // Latest value per symbol until the socket drains
+        }
+    }
+    dirty_.clear();
+}
+
+void WebSocketServer::appendFrame(Connection& connection, uint8_t opcode, const char* payload, size_t length) {
+    appendFrameHeader(connection.output, opcode, length);
+    connection.output.append(payload, length);
+}
+
+void WebSocketServer::flushConnection(Connection& connection) {
+    while (true) {
+        while (connection.queued() > 0) {
+            ssize_t n = send(connection.fd, connection.output.data() + connection.sent, connection.queued(),
+                             MSG_NOSIGNAL);
+            if (n > 0) {
+                connection.sent += static_cast<size_t>(n);
+                bytesSent_ += static_cast<uint64_t>(n);
+            } else if (n < 0 && errno == EINTR) {
+                continue;
+            } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                if (!connection.waitingWritable) {
+                    connection.waitingWritable = true;
+                    watch(epollFd_, EPOLL_CTL_MOD, connection.fd, EPOLLIN | EPOLLOUT, connection.slot);
+                }
+                if (connection.sent > connection.output.size() / 2) {
+                    connection.output.erase(0, connection.sent);
+                    connection.sent = 0;
+                }
+                return;
+            } else {
+                disconnect(connection.slot);
+                return;
+            }
+        }
+        connection.output.clear();
+        connection.sent = 0;
+
+        // Drained: a conflating connection catches up with one frame of the latest records
+        if (!connection.conflating || connection.closing) {
+            break; // Nothing may follow a close frame
+        }
+        connection.conflating = false;
+        if (connection.conflated.empty()) {
+            break;
+        }
+        string records;
+        for (uint32_t symbol : connection.conflated) {
+            if (!records.empty()) {
+                records.push_back(',');
+            }
+            records.append(connection.latest[symbol]);
+            recordsDelivered_ += 1;
+            connection.latest[symbol].clear();
+        }
+        connection.conflated.clear();
+        appendArrayFrame(connection.output, records);
+        ++framesSent_;
+    }
+
+    if (connection.closing) {
+        disconnect(connection.slot);
+        return;
+    }
+    if (connection.waitingWritable) {
+        connection.waitingWritable = false;
+        watch(epollFd_, EPOLL_CTL_MOD, connection.fd, EPOLLIN, connection.slot);
+    }
+}
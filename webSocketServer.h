@@ -0,0 +1,118 @@
+#ifndef MARKET_DATA_WEB_SOCKET_SERVER_H
+#define MARKET_DATA_WEB_SOCKET_SERVER_H
+
+#include <cstddef>    // For size_t
+#include <cstdint>    // For uint32_t, uint64_t
+#include <memory>     // For std::unique_ptr
+#include <mutex>      // For std::mutex
+#include <string>     // For std::string
+#include <thread>     // For std::thread
+#include <vector>     // For std::vector
+#include "feedServer.h" // For FeedChunk, PublishingSink
+#include "subscriberIndex.h" // For SubscriberIndex
+
+// --- WebSocket Feed Server ---
+// Serves published JSON records (see JsonFormatter) to WebSocket clients (RFC 6455) from one
+// epoll event loop thread, with the same publish() interface as FeedServer.
+//   ws://HOST:PORT/?symbols=GOOG,AAPL   subscribe on connect ("*" = everything)
+//   text frames "SUB ..." / "UNSUB ..."  change the subscription later, as on the TCP feed
+// Everything a client gets in one loop iteration goes out as one text frame holding a JSON
+// array of records. Wildcard subscribers share one frame, built once per iteration.
+//
+// Slow clients are conflated instead of disconnected. Once a client has more than
+// kConflateAboveBytes unsent, it stops receiving every record. Only the latest record per
+// symbol is kept, and it is sent as a single frame when the socket drains. Memory per client
+// is therefore bounded, and a stalled browser never holds back the loop or the pipeline.
+class WebSocketServer {
+public:
+    static constexpr size_t kConflateAboveBytes = 256 * 1024;
+
+    // Listens on address (see net::parseEndpoint). Records carry their own framing, so the
+    // formatter header is not used.
+    WebSocketServer(const std::string& address, const std::string& header);
+    ~WebSocketServer();
+
+    WebSocketServer(const WebSocketServer&) = delete;
+    WebSocketServer& operator=(const WebSocketServer&) = delete;
+
+    bool isListening() const { return listenFd_ >= 0; }
+    FeedChunk acquireChunk();
+    void publish(FeedChunk&& chunk);
+
+    // Mirrors this server's subscriptions into demand (from the event loop, shortly after).
+    void trackDemand(SymbolDemand& demand);
+
+    // Fans out everything published, sends close frames, and stops the event loop.
+    void close();
+
+private:
+    struct Connection {
+        int fd;
+        uint32_t slot;
+        std::string input;            // Handshake or frame bytes not parsed yet
+        bool open = false;            // Handshake done
+        bool closing = false;         // Disconnect once output is flushed
+        std::string output;           // output[sent..] is still to be sent
+        size_t sent = 0;
+        bool waitingWritable = false;
+        bool dirty = false;           // Listed in dirty_
+        bool all = false;             // Wildcard subscriber: gets the shared frame
+        std::string batch;            // Records for this iteration's frame, comma separated
+        bool conflating = false;
+        std::vector<uint32_t> conflated; // Symbols with a record in latest
+        std::vector<std::string> latest; // By symbol id; empty = nothing pending
+        std::vector<uint32_t> symbols;   // Subscribed symbol ids (and the wildcard)
+
+        Connection(int socketFd, uint32_t connectionSlot) : fd(socketFd), slot(connectionSlot) {}
+        size_t queued() const { return output.size() - sent; }
+    };
+
+    // --- Event Loop (all below runs on loopThread_ only) ---
+    void eventLoop();
+    void acceptConnections();
+    void readInput(Connection& connection);
+    bool handshake(Connection& connection);
+    bool readFrames(Connection& connection);
+    void handleCommand(Connection& connection, const std::string& text);
+    bool drainPublished();
+    void fanOut(const FeedChunk& chunk);
+    void deliver(Connection& connection, uint32_t symbol, const char* data, size_t length);
+    void markDirty(Connection& connection);
+    void writeFrames();
+    void appendFrame(Connection& connection, uint8_t opcode, const char* payload, size_t length);
+    void flushConnection(Connection& connection);
+    void disconnect(uint32_t slot);
+    void setSubscribed(Connection& connection, uint32_t symbol, bool subscribed);
+
+    int listenFd_ = -1;
+    int epollFd_ = -1;
+    int wakeFd_ = -1;
+    std::string unixPath_;
+
+    std::vector<std::unique_ptr<Connection>> connections_; // By slot; null = free
+    std::vector<uint32_t> freeSlots_;
+    std::vector<uint32_t> released_;
+    std::vector<uint32_t> dirty_;
+    SubscriberIndex subscribers_;
+    std::string broadcast_;           // Wildcard records of this iteration, comma separated
+
+    uint64_t connectionsAccepted_ = 0;
+    uint64_t framesSent_ = 0;
+    uint64_t recordsPublished_ = 0;
+    uint64_t recordsDelivered_ = 0;
+    uint64_t recordsConflated_ = 0;   // Superseded before a slow client could take them
+    uint64_t bytesSent_ = 0;
+
+    // --- Shared with the writer thread ---
+    std::mutex mutex_;
+    std::vector<FeedChunk> published_;
+    std::vector<FeedChunk> spare_;
+    SymbolDemand* pendingDemand_ = nullptr;
+    bool stopping_ = false;
+    std::thread loopThread_;
+};
+
+template <typename Formatter>
+using WebSocketSink = PublishingSink<WebSocketServer, Formatter>;
+
+#endif // MARKET_DATA_WEB_SOCKET_SERVER_H
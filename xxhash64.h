@@ -0,0 +1,125 @@
+#ifndef MARKET_DATA_XXHASH64_H
+#define MARKET_DATA_XXHASH64_H
+
+#include <cstddef>    // For size_t, std::ptrdiff_t
+#include <cstdint>    // For uint64_t
+#include <cstring>    // For std::memcpy
+
+// --- Streaming XXH64 ---
+// Yann Collet's xxHash, 64-bit variant (spec in the xxHash repository, doc/xxhash_spec.md), with
+// the reference streaming interface: update() any number of times, then digest(). Values match
+// the reference XXH64 for the same bytes and seed on little-endian hosts, so manifests can be
+// checked with the xxhsum tool. Used by --regress to checksum outputs and tick streams.
+class XxHash64 {
+public:
+    explicit XxHash64(uint64_t seed = 0) : seed_(seed) {
+        lanes_[0] = seed + kPrime1 + kPrime2;
+        lanes_[1] = seed + kPrime2;
+        lanes_[2] = seed;
+        lanes_[3] = seed - kPrime1;
+    }
+
+    void update(const void* data, size_t length) {
+        const unsigned char* p = static_cast<const unsigned char*>(data);
+        const unsigned char* end = p + length;
+        total_ += length;
+        if (buffered_ + length < kStripe) {
+            std::memcpy(buffer_ + buffered_, p, length);
+            buffered_ += length;
+            return;
+        }
+        if (buffered_ != 0) {
+            size_t fill = kStripe - buffered_;
+            std::memcpy(buffer_ + buffered_, p, fill);
+            consumeStripe(buffer_);
+            p += fill;
+            buffered_ = 0;
+        }
+        for (; end - p >= static_cast<std::ptrdiff_t>(kStripe); p += kStripe) {
+            consumeStripe(p);
+        }
+        buffered_ = static_cast<size_t>(end - p);
+        std::memcpy(buffer_, p, buffered_);
+    }
+
+    // Raw bytes of a trivially copyable value.
+    template <typename T>
+    void add(const T& value) { update(&value, sizeof(value)); }
+
+    uint64_t digest() const {
+        uint64_t hash;
+        if (total_ >= kStripe) {
+            hash = rotl(lanes_[0], 1) + rotl(lanes_[1], 7) + rotl(lanes_[2], 12) + rotl(lanes_[3], 18);
+            for (uint64_t lane : lanes_) {
+                hash = (hash ^ round(0, lane)) * kPrime1 + kPrime4;
+            }
+        } else {
+            hash = seed_ + kPrime5;
+        }
+        hash += total_;
+
+        const unsigned char* p = buffer_;
+        size_t remaining = buffered_;
+        for (; remaining >= 8; p += 8, remaining -= 8) {
+            hash = rotl(hash ^ round(0, read64(p)), 27) * kPrime1 + kPrime4;
+        }
+        if (remaining >= 4) {
+            hash = rotl(hash ^ (read32(p) * kPrime1), 23) * kPrime2 + kPrime3;
+            p += 4;
+            remaining -= 4;
+        }
+        for (; remaining > 0; ++p, --remaining) {
+            hash = rotl(hash ^ (*p * kPrime5), 11) * kPrime1;
+        }
+
+        hash ^= hash >> 33;
+        hash *= kPrime2;
+        hash ^= hash >> 29;
+        hash *= kPrime3;
+        hash ^= hash >> 32;
+        return hash;
+    }
+
+    static uint64_t of(const void* data, size_t length, uint64_t seed = 0) {
+        XxHash64 hash(seed);
+        hash.update(data, length);
+        return hash.digest();
+    }
+
+private:
+    static constexpr size_t kStripe = 32;
+    static constexpr uint64_t kPrime1 = 0x9E3779B185EBCA87ULL;
+    static constexpr uint64_t kPrime2 = 0xC2B2AE3D27D4EB4FULL;
+    static constexpr uint64_t kPrime3 = 0x165667B19E3779F9ULL;
+    static constexpr uint64_t kPrime4 = 0x85EBCA77C2B2AE63ULL;
+    static constexpr uint64_t kPrime5 = 0x27D4EB2F165667C5ULL;
+
+    static uint64_t rotl(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+    static uint64_t round(uint64_t lane, uint64_t input) { return rotl(lane + input * kPrime2, 31) * kPrime1; }
+
+    static uint64_t read64(const unsigned char* p) {
+        uint64_t value;
+        std::memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    static uint64_t read32(const unsigned char* p) {
+        uint32_t value;
+        std::memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    void consumeStripe(const unsigned char* p) {
+        for (int i = 0; i < 4; ++i) {
+            lanes_[i] = round(lanes_[i], read64(p + 8 * i));
+        }
+    }
+
+    uint64_t seed_;
+    uint64_t lanes_[4];
+    uint64_t total_ = 0;
+    unsigned char buffer_[kStripe];
+    size_t buffered_ = 0;
+};
+
+#endif // MARKET_DATA_XXHASH64_H